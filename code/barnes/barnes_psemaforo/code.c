@@ -19,6 +19,9 @@ Usage: BARNES <options> < inputfile
 Command line options:
 
     -h : Print out input file description
+    --affinity=compact|scatter|list:0,2,4-7 : Pin each process/thread to
+         a CPU (-a)
+    --numa=local|interleave : NUMA memory policy for the shared data (-N)
 
     Input parameters should be placed in a file and redirected through
     standard input.  There are a total of twelve parameters, and all of
@@ -79,6 +82,7 @@ Command line options:
 #include <sys/types.h>
 #include <sys/shm.h>
 #include <unistd.h>
+#include <getopt.h>
 #include <stdlib.h>
 #include <stdio.h>
 #define MAX_THREADS 1024
@@ -90,6 +94,7 @@ pthread_t PThreadTable[MAX_THREADS];
 
 #include "code.h"
 #include "defs.h"
+#include "Placement.h"
 #include <math.h>
 #include <time.h>
 
@@ -125,20 +130,36 @@ void getMemAdds(int ct, int btab, int lcl);
 main(int argc, string argv[]) {
     int c;
 
-    while ((c = getopt(argc, argv, "h")) != -1) {
+    struct option longopts[] = {
+        {"affinity", 1, NULL, 'a'},
+        {"numa", 1, NULL, 'N'},
+        {NULL, 0, NULL, 0}
+    };
+
+    while ((c = getopt_long(argc, argv, "ha:N:", longopts, NULL)) != -1) {
         switch(c) {
             case 'h':
                 Help();
                 exit(-1);
                 break;
 
+            case 'a':
+                placementAffinity(optarg);
+                break;
+
+            case 'N':
+                placementNuma(optarg);
+                break;
+
             default:
-                fprintf(stderr, "Only valid option is \"-h\".\n");
+                fprintf(stderr, "Valid options are \"-h\", \"--affinity\" and \"--numa\".\n");
                 exit(-1);
                 break;
         }
     }
 
+    /* before any allocation, so the NUMA policy covers it */
+    placementInit();
     ANLinit();
     initparam(argv, defv);
     startrun();
@@ -159,6 +180,8 @@ main(int argc, string argv[]) {
         (Global->computestart) = (unsigned long)(FullTime.tv_usec + FullTime.tv_sec * 1000000);
     };
 
+    placementPrintInfo(globalDefs->NPROC);
+    printf("\n");
     printf("COMPUTESTART  = %12lu\n",Global->computestart);
 
     {
@@ -446,8 +469,8 @@ tab_init(){
  * SLAVESTART: main task for each processor
  */
 void SlaveStart(){
-/* POSSIBLE ENHANCEMENT:  Here is where one might pin processes to
-   processors to avoid migration */
+   /* pin processes to processors to avoid migration (--affinity) */
+   placementPin(ProcessId);
    getMemAdds(1, 1, 1);
    /* initialize mybodytabs */
    Local[ProcessId].mybodytab = Local[0].mybodytab + (globalDefs->maxmybody * ProcessId);
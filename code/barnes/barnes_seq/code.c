@@ -19,6 +19,9 @@ Usage: BARNES <options> < inputfile
 Command line options:
 
     -h : Print out input file description
+    --affinity=compact|scatter|list:0,2,4-7 : Pin each process/thread to
+         a CPU (-a)
+    --numa=local|interleave : NUMA memory policy for the shared data (-N)
 
     Input parameters should be placed in a file and redirected through
     standard input.  There are a total of twelve parameters, and all of
@@ -67,6 +70,7 @@ Command line options:
 
 #include <sys/time.h>
 #include <unistd.h>
+#include <getopt.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <errno.h>
@@ -78,6 +82,7 @@ Command line options:
 
 #include "code.h"
 #include "defs.h"
+#include "Placement.h"
 #include <math.h>
 #include <time.h>
 
@@ -113,20 +118,36 @@ main(int argc, string argv[]) {
     unsigned ProcessId = 0;
     int c;
 
-    while ((c = getopt(argc, argv, "h")) != -1) {
+    struct option longopts[] = {
+        {"affinity", 1, NULL, 'a'},
+        {"numa", 1, NULL, 'N'},
+        {NULL, 0, NULL, 0}
+    };
+
+    while ((c = getopt_long(argc, argv, "ha:N:", longopts, NULL)) != -1) {
         switch(c) {
             case 'h':
                 Help();
                 exit(-1);
                 break;
 
+            case 'a':
+                placementAffinity(optarg);
+                break;
+
+            case 'N':
+                placementNuma(optarg);
+                break;
+
             default:
-                fprintf(stderr, "Only valid option is \"-h\".\n");
+                fprintf(stderr, "Valid options are \"-h\", \"--affinity\" and \"--numa\".\n");
                 exit(-1);
                 break;
         }
     }
 
+    /* before any allocation, so the NUMA policy covers it */
+    placementInit();
     ANLinit();
     initparam(argv, defv);
     startrun();
@@ -149,6 +170,8 @@ main(int argc, string argv[]) {
         (Global->computestart) = (unsigned long)(FullTime.tv_usec + FullTime.tv_sec * 1000000);
     };
 
+    placementPrintInfo(1);
+    printf("\n");
     printf("COMPUTESTART  = %12lu\n",Global->computestart);
 
     SlaveStart();
@@ -283,8 +306,8 @@ void SlaveStart(){
    //TRECHO QUE ERA PARALELO
    ProcessId = Global->current_id;
 
-/* POSSIBLE ENHANCEMENT:  Here is where one might pin processes to
-   processors to avoid migration */
+   /* pin processes to processors to avoid migration (--affinity) */
+   placementPin(ProcessId);
 
    /* initialize mybodytabs */
    Local[ProcessId].mybodytab = Local[0].mybodytab + (maxmybody * ProcessId);
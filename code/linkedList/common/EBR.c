@@ -0,0 +1,182 @@
+/* Reclamação de memória baseada em épocas (EBR)                         */
+/* Um nó removido vai para a lista de limbo da época em que foi aposentado */
+/* e só é liberado quando a época global avançou duas vezes, ou seja,     */
+/* quando nenhuma thread que possa ter visto o nó ainda está numa operação */
+
+#include "EBR.h"
+
+ebr_t ebr;
+static __thread ebr_thread_t* self = NULL;
+
+static double elapsedMs(struct timespec* start, struct timespec* end){
+  return (end->tv_sec - start->tv_sec) * 1.0e3 + (end->tv_nsec - start->tv_nsec) * 1.0e-6;
+}
+
+/* reclaim é a função que devolve o nó ao alocador (free ou poolFree) */
+void ebrInit(int n_threads, size_t node_size, void (*reclaim)(void*)){
+  int i, j;
+
+  ebr.epoch = 0;
+  ebr.n_threads = n_threads;
+  ebr.node_size = node_size;
+  ebr.reclaim = reclaim;
+  ebr.threads = aligned_alloc(CACHE_LINE, sizeof(ebr_thread_t) * n_threads);
+
+  for(i = 0; i < n_threads; i++){
+    ebr.threads[i].active = 0;
+    ebr.threads[i].epoch = 0;
+    ebr.threads[i].retired = 0;
+    ebr.threads[i].freed = 0;
+    ebr.threads[i].in_limbo = 0;
+    ebr.threads[i].peak_limbo = 0;
+    ebr.threads[i].batches = 0;
+    ebr.threads[i].latency_sum = 0;
+    ebr.threads[i].latency_max = 0;
+
+    for(j = 0; j < 3; j++){
+      ebr.threads[i].limbo[j].size = 0;
+      ebr.threads[i].limbo[j].capacity = EBR_BATCH;
+      ebr.threads[i].limbo[j].nodes = malloc(sizeof(void*) * EBR_BATCH);
+      ebr.threads[i].limbo[j].epoch = 0;
+    }
+  }
+}
+
+/* Associa a thread corrente ao registro tid, deve ser chamada antes do primeiro ebrEnter */
+void ebrRegister(int tid){
+  self = &ebr.threads[tid];
+}
+
+/* Libera de uma vez todos os nós de uma lista de limbo */
+static void freeLimbo(ebr_thread_t* t, limbo_t* l){
+  struct timespec now;
+  double latency;
+  int i;
+
+  if(l->size == 0)
+    return;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  latency = elapsedMs(&l->first_retire, &now);
+  t->latency_sum += latency;
+  if(latency > t->latency_max)
+    t->latency_max = latency;
+  t->batches++;
+
+  for(i = 0; i < l->size; i++)
+    ebr.reclaim(l->nodes[i]);
+
+  t->freed += l->size;
+  t->in_limbo -= l->size;
+  l->size = 0;
+}
+
+/* Avança a época global se todas as threads ativas já a observaram */
+static void tryAdvance(){
+  unsigned long e = __atomic_load_n(&ebr.epoch, __ATOMIC_SEQ_CST);
+  int i;
+
+  for(i = 0; i < ebr.n_threads; i++){
+    if(__atomic_load_n(&ebr.threads[i].active, __ATOMIC_SEQ_CST) &&
+       __atomic_load_n(&ebr.threads[i].epoch, __ATOMIC_SEQ_CST) != e)
+      return;
+  }
+
+  __atomic_compare_exchange_n(&ebr.epoch, &e, e + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+/* Início de uma operação: a partir daqui os nós lidos não podem ser liberados */
+void ebrEnter(){
+  unsigned long e;
+  int i;
+
+  // sem registro só a thread principal roda, antes ou depois das threads
+  if(self == NULL)
+    return;
+
+  __atomic_store_n(&self->active, 1, __ATOMIC_SEQ_CST);
+  e = __atomic_load_n(&ebr.epoch, __ATOMIC_SEQ_CST);
+  __atomic_store_n(&self->epoch, e, __ATOMIC_SEQ_CST);
+
+  // limbos aposentados duas épocas atrás não são mais alcançáveis por ninguém
+  for(i = 0; i < 3; i++){
+    if(self->limbo[i].size > 0 && self->limbo[i].epoch + 2 <= e)
+      freeLimbo(self, &self->limbo[i]);
+  }
+}
+
+void ebrExit(){
+  if(self == NULL)
+    return;
+
+  __atomic_store_n(&self->active, 0, __ATOMIC_RELEASE);
+}
+
+/* Aposenta um nó já desligado da estrutura */
+void ebrRetire(void* node){
+  limbo_t* l;
+  unsigned long e;
+
+  if(self == NULL){
+    ebr.reclaim(node);
+    return;
+  }
+
+  // tagged with the global epoch, not ours: while we are still in e the
+  // global one may be e + 1 already, and a reader that entered in e + 1
+  // may hold this node until the epoch moves to e + 3
+  e = __atomic_load_n(&ebr.epoch, __ATOMIC_SEQ_CST);
+  l = &self->limbo[e % 3];
+  if(l->size > 0 && l->epoch != e)
+    freeLimbo(self, l);           // tagged at e - 3 or earlier, already safe
+  if(l->size == 0){
+    l->epoch = e;
+    clock_gettime(CLOCK_MONOTONIC, &l->first_retire);
+  }
+
+  if(l->size == l->capacity){
+    l->capacity *= 2;
+    l->nodes = realloc(l->nodes, sizeof(void*) * l->capacity);
+  }
+  l->nodes[l->size++] = node;
+
+  self->retired++;
+  self->in_limbo++;
+  if(self->in_limbo > self->peak_limbo)
+    self->peak_limbo = self->in_limbo;
+
+  if(self->retired % EBR_BATCH == 0)
+    tryAdvance();
+}
+
+/* Libera tudo o que ainda está em limbo, só pode ser chamada sem threads rodando */
+void ebrFlush(){
+  int i, j;
+
+  for(i = 0; i < ebr.n_threads; i++)
+    for(j = 0; j < 3; j++)
+      freeLimbo(&ebr.threads[i], &ebr.threads[i].limbo[j]);
+}
+
+void ebrPrintStats(){
+  long retired = 0, freed = 0, peak = 0, batches = 0;
+  double latency_sum = 0, latency_max = 0;
+  int i;
+
+  for(i = 0; i < ebr.n_threads; i++){
+    retired += ebr.threads[i].retired;
+    freed += ebr.threads[i].freed;
+    peak += ebr.threads[i].peak_limbo;
+    batches += ebr.threads[i].batches;
+    latency_sum += ebr.threads[i].latency_sum;
+    if(ebr.threads[i].latency_max > latency_max)
+      latency_max = ebr.threads[i].latency_max;
+  }
+
+  printf("EBR: nós aposentados = %ld, liberados durante a execução = %ld\n", retired, freed);
+  printf("EBR: pico de memória em limbo = %ld bytes (soma dos picos por thread)\n",
+         peak * (long) ebr.node_size);
+  if(batches > 0)
+    printf("EBR: latência de reclamação = %lf ms média / %lf ms máxima (%ld lotes)\n",
+           latency_sum / batches, latency_max, batches);
+}
@@ -0,0 +1,61 @@
+#ifndef EBR_H
+#define EBR_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#ifndef CACHE_LINE
+#define CACHE_LINE 64
+#endif
+
+/* Número de retires entre tentativas de avançar a época global */
+#define EBR_BATCH 64
+
+/* Uma lista de limbo: nós aposentados numa mesma época */
+typedef struct limbo_t{
+  void** nodes;
+  int size;
+  int capacity;
+  unsigned long epoch;
+  struct timespec first_retire;
+} limbo_t;
+
+/* Registro de uma thread, cada um na sua linha de cache */
+typedef struct ebr_thread_t{
+  int active;
+  unsigned long epoch;
+  limbo_t limbo[3];
+  long retired;
+  long freed;
+  long in_limbo;
+  long peak_limbo;
+  long batches;
+  double latency_sum;
+  double latency_max;
+} __attribute__((aligned(CACHE_LINE))) ebr_thread_t;
+
+typedef struct ebr_t{
+  unsigned long epoch __attribute__((aligned(CACHE_LINE)));
+  ebr_thread_t* threads;
+  int n_threads;
+  size_t node_size;
+  void (*reclaim)(void*);
+} ebr_t;
+
+extern ebr_t ebr;
+
+void ebrInit(int n_threads, size_t node_size, void (*reclaim)(void*));
+
+void ebrRegister(int tid);
+
+void ebrEnter();
+
+void ebrExit();
+
+void ebrRetire(void* node);
+
+void ebrFlush();
+
+void ebrPrintStats();
+#endif
@@ -0,0 +1,164 @@
+/* Pool de nós por thread                                                */
+/* Cada thread aloca de uma free list própria, preenchida por slabs       */
+/* alinhados à linha de cache; nós liberados por outra thread voltam ao   */
+/* dono em lotes de POOL_RETURN_BATCH por uma pilha sem locks             */
+
+#include "NodePool.h"
+
+pools_t node_pools;
+static __thread node_pool_t* self = NULL;
+
+/* Arredonda o tamanho para que nenhum nó atravesse duas linhas de cache */
+static size_t objSize(size_t size){
+  size_t s = sizeof(pool_obj_t);
+
+  if(size > CACHE_LINE)
+    return (size + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+
+  while(s < size)
+    s *= 2;
+  return s;
+}
+
+/* Cria n_threads + 1 pools, o último é o da thread principal (warm up) */
+void poolInit(int n_threads, size_t obj_size){
+  int i;
+
+  node_pools.n_pools = n_threads + 1;
+  node_pools.obj_size = objSize(obj_size);
+  node_pools.pools = aligned_alloc(CACHE_LINE, sizeof(node_pool_t) * node_pools.n_pools);
+
+  for(i = 0; i < node_pools.n_pools; i++){
+    node_pools.pools[i].remote = NULL;
+    node_pools.pools[i].free_list = NULL;
+    node_pools.pools[i].slabs = NULL;
+    node_pools.pools[i].outgoing = calloc(node_pools.n_pools, sizeof(pool_batch_t));
+    node_pools.pools[i].allocs = 0;
+    node_pools.pools[i].slab_count = 0;
+    node_pools.pools[i].remote_frees = 0;
+    node_pools.pools[i].remote_batches = 0;
+    node_pools.pools[i].refills = 0;
+  }
+}
+
+/* Associa a thread corrente ao pool tid, deve ser chamada antes do primeiro poolAlloc */
+void poolRegister(int tid){
+  self = &node_pools.pools[tid];
+}
+
+static node_pool_t* myPool(){
+  if(self == NULL)
+    self = &node_pools.pools[node_pools.n_pools - 1];
+  return self;
+}
+
+static void newSlab(node_pool_t* pool){
+  slab_t* slab = aligned_alloc(SLAB_SIZE, SLAB_SIZE);
+  char* obj = (char*) slab + sizeof(slab_t);
+  char* end = (char*) slab + SLAB_SIZE - node_pools.obj_size;
+
+  slab->owner = pool;
+  slab->next = pool->slabs;
+  pool->slabs = slab;
+  pool->slab_count++;
+
+  for(; obj <= end; obj += node_pools.obj_size){
+    ((pool_obj_t*) obj)->next = pool->free_list;
+    pool->free_list = (pool_obj_t*) obj;
+  }
+}
+
+void* poolAlloc(){
+  node_pool_t* pool = myPool();
+  pool_obj_t* obj;
+
+  if(pool->free_list == NULL){
+    // pega de uma vez tudo o que as outras threads devolveram
+    pool->free_list = __atomic_exchange_n(&pool->remote, NULL, __ATOMIC_ACQUIRE);
+    if(pool->free_list != NULL)
+      pool->refills++;
+    else
+      newSlab(pool);
+  }
+
+  obj = pool->free_list;
+  pool->free_list = obj->next;
+  pool->allocs++;
+
+  return obj;
+}
+
+/* Empilha um lote inteiro na pilha remote do dono; só o dono desempilha, e
+   sempre a pilha toda, então não há ABA */
+static void pushRemote(node_pool_t* owner, pool_batch_t* batch){
+  pool_obj_t* old = __atomic_load_n(&owner->remote, __ATOMIC_RELAXED);
+
+  do{
+    batch->tail->next = old;
+  }while(!__atomic_compare_exchange_n(&owner->remote, &old, batch->head, 0,
+                                      __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+  batch->head = batch->tail = NULL;
+  batch->size = 0;
+}
+
+void poolFree(void* ptr){
+  node_pool_t* pool = myPool();
+  slab_t* slab = (slab_t*) ((uintptr_t) ptr & ~((uintptr_t) SLAB_SIZE - 1));
+  node_pool_t* owner = slab->owner;
+  pool_obj_t* obj = ptr;
+  pool_batch_t* batch;
+
+  if(owner == pool){
+    obj->next = pool->free_list;
+    pool->free_list = obj;
+    return;
+  }
+
+  batch = &pool->outgoing[owner - node_pools.pools];
+  obj->next = batch->head;
+  batch->head = obj;
+  if(batch->tail == NULL)
+    batch->tail = obj;
+  batch->size++;
+  pool->remote_frees++;
+
+  if(batch->size == POOL_RETURN_BATCH){
+    pushRemote(owner, batch);
+    pool->remote_batches++;
+  }
+}
+
+/* Libera todos os slabs, só pode ser chamada sem threads rodando */
+void poolDestroy(){
+  slab_t* slab;
+  int i;
+
+  for(i = 0; i < node_pools.n_pools; i++){
+    while(node_pools.pools[i].slabs != NULL){
+      slab = node_pools.pools[i].slabs;
+      node_pools.pools[i].slabs = slab->next;
+      free(slab);
+    }
+    free(node_pools.pools[i].outgoing);
+  }
+  free(node_pools.pools);
+}
+
+void poolPrintStats(){
+  long allocs = 0, slabs = 0, remote_frees = 0, remote_batches = 0, refills = 0;
+  int i;
+
+  for(i = 0; i < node_pools.n_pools; i++){
+    allocs += node_pools.pools[i].allocs;
+    slabs += node_pools.pools[i].slab_count;
+    remote_frees += node_pools.pools[i].remote_frees;
+    remote_batches += node_pools.pools[i].remote_batches;
+    refills += node_pools.pools[i].refills;
+  }
+
+  printf("Pool: %ld alocações, %ld slabs de %d KB, nós de %zu bytes\n",
+         allocs, slabs, SLAB_SIZE / 1024, node_pools.obj_size);
+  printf("Pool: %ld liberações remotas em %ld lotes, %ld recargas a partir de lotes\n",
+         remote_frees, remote_batches, refills);
+}
@@ -0,0 +1,69 @@
+#ifndef NODEPOOL_H
+#define NODEPOOL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#ifndef CACHE_LINE
+#define CACHE_LINE 64
+#endif
+
+/* Slabs são alinhados ao próprio tamanho para achar o dono a partir do nó */
+#define SLAB_SIZE (64 * 1024)
+
+/* Nós devolvidos a outra thread são acumulados e entregues em lotes */
+#define POOL_RETURN_BATCH 32
+
+typedef struct pool_obj_t{
+  struct pool_obj_t* next;
+} pool_obj_t;
+
+/* Cabeçalho do slab, ocupa a primeira linha de cache */
+typedef struct slab_t{
+  struct node_pool_t* owner;
+  struct slab_t* next;
+} __attribute__((aligned(CACHE_LINE))) slab_t;
+
+/* Lote de nós indo para outra thread */
+typedef struct pool_batch_t{
+  pool_obj_t* head;
+  pool_obj_t* tail;
+  int size;
+} pool_batch_t;
+
+typedef struct node_pool_t{
+  /* Nós devolvidos por outras threads, a única parte escrita por elas */
+  pool_obj_t* remote __attribute__((aligned(CACHE_LINE)));
+
+  /* Daqui em diante só a thread dona acessa */
+  pool_obj_t* free_list __attribute__((aligned(CACHE_LINE)));
+  slab_t* slabs;
+  pool_batch_t* outgoing;
+  long allocs;
+  long slab_count;
+  long remote_frees;
+  long remote_batches;
+  long refills;
+} __attribute__((aligned(CACHE_LINE))) node_pool_t;
+
+typedef struct pools_t{
+  node_pool_t* pools;
+  int n_pools;
+  size_t obj_size;
+} pools_t;
+
+extern pools_t node_pools;
+
+void poolInit(int n_threads, size_t obj_size);
+
+void poolRegister(int tid);
+
+void* poolAlloc();
+
+void poolFree(void* obj);
+
+void poolDestroy();
+
+void poolPrintStats();
+#endif
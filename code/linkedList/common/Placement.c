@@ -0,0 +1,291 @@
+/* Posicionamento das threads e processos                                */
+/* --affinity fixa a thread tid numa CPU de uma ordem calculada a partir */
+/* da topologia em /sys (compact ou scatter) ou dada pelo usuário; a     */
+/* --numa ajusta a política de memória da thread principal antes das     */
+/* alocações, e ela é herdada pelas threads criadas e pelos filhos       */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <string.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#include "Placement.h"
+
+#define TRUE 1
+#define FALSE 0
+
+placement_t placement = { AFF_NONE, NUMA_NONE, NULL };
+
+/* Topologia de uma CPU, só usada para ordenar */
+typedef struct cpu_topo_t{
+  int cpu;
+  int package;
+  int core;                     // posição do núcleo dentro do pacote
+  int smt;                      // posição da CPU dentro do núcleo
+} cpu_topo_t;
+
+/* Lê o inteiro de um arquivo de /sys, -1 se não existir */
+static int readSysInt(const char* fmt, int cpu){
+  char path[128];
+  FILE* f;
+  int v = -1;
+
+  snprintf(path, sizeof(path), fmt, cpu);
+  f = fopen(path, "r");
+  if(f == NULL)
+    return -1;
+  if(fscanf(f, "%d", &v) != 1)
+    v = -1;
+  fclose(f);
+  return v;
+}
+
+/* Lê uma lista no formato do kernel ("0,2,4-7"); devolve o tamanho ou -1 */
+static int parseList(const char* s, int* out, int max){
+  int n = 0;
+  char* end;
+
+  while(*s != '\0' && *s != '\n'){
+    long a = strtol(s, &end, 10);
+    long b = a;
+
+    if(end == s || a < 0)
+      return -1;
+    s = end;
+    if(*s == '-'){
+      b = strtol(s + 1, &end, 10);
+      if(end == s + 1 || b < a)
+        return -1;
+      s = end;
+    }
+    for(; a <= b; a++){
+      if(n == max)
+        return -1;
+      out[n++] = (int) a;
+    }
+    if(*s == ',')
+      s++;
+    else if(*s != '\0' && *s != '\n')
+      return -1;
+  }
+  return n;
+}
+
+void placementAffinity(const char* spec){
+  if(strcmp(spec, "compact") == 0)
+    placement.affinity = AFF_COMPACT;
+  else if(strcmp(spec, "scatter") == 0)
+    placement.affinity = AFF_SCATTER;
+  else if(strncmp(spec, "list:", 5) == 0){
+    placement.affinity = AFF_LIST;
+    placement.cpu_list = spec + 5;
+  }
+  else{
+    printf("Afinidade inválida: %s (use compact, scatter ou list:0,2,4-7). Abortando...\n", spec);
+    exit(1);
+  }
+}
+
+void placementNuma(const char* spec){
+  if(strcmp(spec, "local") == 0)
+    placement.numa = NUMA_LOCAL;
+  else if(strcmp(spec, "interleave") == 0)
+    placement.numa = NUMA_INTERLEAVE;
+  else{
+    printf("Política NUMA inválida: %s (use local ou interleave). Abortando...\n", spec);
+    exit(1);
+  }
+}
+
+static int compactOrder(const void* a, const void* b){
+  const cpu_topo_t* x = (const cpu_topo_t*) a;
+  const cpu_topo_t* y = (const cpu_topo_t*) b;
+
+  if(x->package != y->package) return x->package - y->package;
+  if(x->core != y->core) return x->core - y->core;
+  return x->smt - y->smt;
+}
+
+static int scatterOrder(const void* a, const void* b){
+  const cpu_topo_t* x = (const cpu_topo_t*) a;
+  const cpu_topo_t* y = (const cpu_topo_t*) b;
+
+  if(x->smt != y->smt) return x->smt - y->smt;
+  if(x->core != y->core) return x->core - y->core;
+  return x->package - y->package;
+}
+
+/* Ordena as CPUs permitidas ao processo segundo compact ou scatter */
+static void topologyOrder(cpu_set_t* allowed){
+  static cpu_topo_t topo[PLACEMENT_MAX_CPUS];
+  static int core_id[PLACEMENT_MAX_CPUS];
+  int n = 0;
+  int i, j, cpu;
+
+  for(cpu = 0; cpu < CPU_SETSIZE && n < PLACEMENT_MAX_CPUS; cpu++){
+    if(!CPU_ISSET(cpu, allowed))
+      continue;
+    topo[n].cpu = cpu;
+    topo[n].package = readSysInt("/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+    core_id[n] = readSysInt("/sys/devices/system/cpu/cpu%d/topology/core_id", cpu);
+    n++;
+  }
+
+  // numera as CPUs que dividem um núcleo (irmãs SMT) pela ordem do id
+  for(i = 0; i < n; i++){
+    topo[i].smt = 0;
+    for(j = 0; j < n; j++){
+      if(topo[j].package == topo[i].package && core_id[j] == core_id[i] &&
+         topo[j].cpu < topo[i].cpu)
+        topo[i].smt++;
+    }
+  }
+
+  // core_id não é contínuo: troca pela posição do núcleo no pacote,
+  // contando cada núcleo menor uma vez só (pela sua primeira CPU)
+  for(i = 0; i < n; i++){
+    topo[i].core = 0;
+    for(j = 0; j < n; j++){
+      if(topo[j].package == topo[i].package && core_id[j] < core_id[i] &&
+         topo[j].smt == 0)
+        topo[i].core++;
+    }
+  }
+
+  qsort(topo, n, sizeof(cpu_topo_t),
+        placement.affinity == AFF_COMPACT ? compactOrder : scatterOrder);
+
+  for(i = 0; i < n; i++)
+    placement.cpus[i] = topo[i].cpu;
+  placement.n_cpus = n;
+}
+
+/* Nós NUMA com memória; sem /sys (ou sem NUMA) há só o nó 0 */
+static int memoryNodes(int* nodes){
+  char buf[256];
+  FILE* f = fopen("/sys/devices/system/node/has_memory", "r");
+  int n = -1;
+
+  if(f == NULL)
+    f = fopen("/sys/devices/system/node/online", "r");
+  if(f != NULL){
+    if(fgets(buf, sizeof(buf), f) != NULL)
+      n = parseList(buf, nodes, PLACEMENT_MAX_CPUS);
+    fclose(f);
+  }
+  if(n < 1){
+    nodes[0] = 0;
+    n = 1;
+  }
+  return n;
+}
+
+static void applyNuma(){
+  static int nodes[PLACEMENT_MAX_CPUS];
+  unsigned long mask[PLACEMENT_MAX_CPUS / (8 * sizeof(unsigned long))];
+  int i;
+  long r;
+
+  placement.n_nodes = memoryNodes(nodes);
+  placement.numa_ok = TRUE;
+  if(placement.numa == NUMA_NONE)
+    return;
+
+  // sem libnuma: a chamada de sistema direto, com as constantes do kernel
+  if(placement.numa == NUMA_LOCAL)
+    r = syscall(SYS_set_mempolicy, MPOL_LOCAL, NULL, 0);
+  else{
+    memset(mask, 0, sizeof(mask));
+    for(i = 0; i < placement.n_nodes; i++)
+      mask[nodes[i] / (8 * sizeof(unsigned long))] |= 1UL << (nodes[i] % (8 * sizeof(unsigned long)));
+    r = syscall(SYS_set_mempolicy, MPOL_INTERLEAVE, mask, sizeof(mask) * 8);
+  }
+
+  if(r != 0){
+    printf("Aviso: o kernel recusou a política NUMA, seguindo com a padrão\n");
+    placement.numa_ok = FALSE;
+  }
+}
+
+/* Deve ser chamada logo depois de ler as opções, antes das alocações
+   grandes e antes de criar threads ou processos */
+void placementInit(){
+  cpu_set_t allowed;
+  int i;
+
+  applyNuma();
+  if(placement.affinity == AFF_NONE)
+    return;
+
+  CPU_ZERO(&allowed);
+  if(sched_getaffinity(0, sizeof(allowed), &allowed) != 0){
+    printf("Não foi possível ler as CPUs disponíveis. Abortando...\n");
+    exit(1);
+  }
+
+  if(placement.affinity != AFF_LIST){
+    topologyOrder(&allowed);
+    return;
+  }
+
+  placement.n_cpus = parseList(placement.cpu_list, placement.cpus, PLACEMENT_MAX_CPUS);
+  if(placement.n_cpus < 1){
+    printf("Lista de CPUs inválida: %s. Abortando...\n", placement.cpu_list);
+    exit(1);
+  }
+  for(i = 0; i < placement.n_cpus; i++){
+    if(placement.cpus[i] >= CPU_SETSIZE || !CPU_ISSET(placement.cpus[i], &allowed)){
+      printf("A CPU %d não está disponível para o processo. Abortando...\n", placement.cpus[i]);
+      exit(1);
+    }
+  }
+}
+
+/* Fixa a thread (ou processo) que chama na CPU da posição tid */
+void placementPin(int tid){
+  cpu_set_t set;
+  int cpu;
+
+  if(placement.affinity == AFF_NONE)
+    return;
+
+  cpu = placement.cpus[tid % placement.n_cpus];
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  if(sched_setaffinity(0, sizeof(set), &set) != 0)
+    printf("Aviso: não foi possível fixar a thread %d na CPU %d\n", tid, cpu);
+}
+
+static const char* affinityName(){
+  switch(placement.affinity){
+    case AFF_COMPACT: return "compact";
+    case AFF_SCATTER: return "scatter";
+    case AFF_LIST: return "list";
+    default: return "nenhuma (escalonador do sistema)";
+  }
+}
+
+void placementPrintInfo(int n_threads){
+  int i;
+
+  printf("\nAfinidade: %s", affinityName());
+  if(placement.affinity != AFF_NONE){
+    printf(" (threads -> CPUs:");
+    for(i = 0; i < n_threads; i++)
+      printf(" %d", placement.cpus[i % placement.n_cpus]);
+    printf(")");
+  }
+
+  if(placement.numa == NUMA_LOCAL)
+    printf("\nNUMA: local (%d nós com memória)", placement.n_nodes);
+  else if(placement.numa == NUMA_INTERLEAVE)
+    printf("\nNUMA: interleave entre %d nós", placement.n_nodes);
+  else
+    printf("\nNUMA: política padrão do sistema");
+  if(!placement.numa_ok)
+    printf(" (recusada pelo kernel)");
+}
@@ -0,0 +1,41 @@
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Afinidade: onde cada thread (ou processo) é fixada */
+#define AFF_NONE 0                 // o escalonador decide, como antes
+#define AFF_COMPACT 1              // enche um pacote (e os irmãos SMT) antes do próximo
+#define AFF_SCATTER 2              // espalha pelos pacotes e núcleos antes de usar SMT
+#define AFF_LIST 3                 // lista de CPUs dada pelo usuário, na ordem
+
+/* Política de memória NUMA, herdada pelas threads e pelos filhos do fork */
+#define NUMA_NONE 0
+#define NUMA_LOCAL 1               // páginas no nó de quem as toca primeiro
+#define NUMA_INTERLEAVE 2          // páginas alternadas entre os nós com memória
+
+#define PLACEMENT_MAX_CPUS 1024
+
+typedef struct placement_t{
+  int affinity;
+  int numa;
+  const char* cpu_list;         // texto de --affinity=list:...
+  int cpus[PLACEMENT_MAX_CPUS]; // ordem de ocupação: a thread tid vai para cpus[tid % n_cpus]
+  int n_cpus;
+  int n_nodes;
+  int numa_ok;                  // FALSE se o kernel recusou a política
+} placement_t;
+
+extern placement_t placement;
+
+void placementAffinity(const char* spec);
+
+void placementNuma(const char* spec);
+
+void placementInit();
+
+void placementPin(int tid);
+
+void placementPrintInfo(int n_threads);
+#endif
@@ -0,0 +1,390 @@
+/* Locks de fila: ticket, MCS e CLH, com o TAS como base de comparação    */
+/* No MCS e no CLH cada thread espera numa linha de cache própria, então  */
+/* a passagem do lock invalida só a linha de quem é o próximo; o ticket   */
+/* mantém a ordem FIFO mas todos leem o mesmo contador, com espera        */
+/* proporcional à distância na fila para aliviar a linha                  */
+/* O adaptive gira com backoff exponencial enquanto o tempo de espera for */
+/* da ordem do tempo médio com o lock, e depois dorme num futex           */
+
+#include <string.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include "QLock.h"
+
+#define TRUE 1
+#define FALSE 0
+
+#define LOAD(addr) __atomic_load_n((addr), __ATOMIC_ACQUIRE)
+#define STORE(addr, v) __atomic_store_n((addr), (v), __ATOMIC_RELEASE)
+
+/* Voltas de espera antes de ceder a CPU (threads a mais que núcleos) */
+#define QLOCK_SPINS 1024
+
+/* Pausas por posição na fila do ticket */
+#define QLOCK_TICKET_BACKOFF 16
+
+/* adaptive: limites da espera girando, em ciclos; se o lock costuma ficar
+   preso mais que o máximo, girar não compensa e a thread dorme logo */
+#define QLOCK_MIN_SPIN 512
+#define QLOCK_MAX_SPIN (64 * 1024)
+#define QLOCK_MAX_BACKOFF 64
+
+#if defined(__x86_64__) || defined(__i386__)
+#define cpuRelax() __builtin_ia32_pause()
+#define cycles() ((long) __builtin_ia32_rdtsc())
+#else
+#define cpuRelax() __asm__ __volatile__("" ::: "memory")
+#define cycles() nowNs()
+#endif
+
+static qlock_stats_t qlock_stats[QLOCK_MAX_THREADS];
+static __thread qlock_stats_t* self = NULL;
+
+/* Nós de espera da thread: um por lock segurado ao mesmo tempo. No CLH o
+   nó de um slot vira o do antecessor a cada saída */
+static __thread qnode_t* my_nodes[QLOCK_NESTING];
+static __thread int my_used[QLOCK_NESTING];
+
+static long nowNs(){
+  struct timespec t;
+
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1000000000L + t.tv_nsec;
+}
+
+int qlockKind(const char* spec){
+  if(strcmp(spec, "tas") == 0)
+    return QLOCK_TAS;
+  if(strcmp(spec, "ticket") == 0)
+    return QLOCK_TICKET;
+  if(strcmp(spec, "mcs") == 0)
+    return QLOCK_MCS;
+  if(strcmp(spec, "clh") == 0)
+    return QLOCK_CLH;
+  if(strcmp(spec, "adaptive") == 0)
+    return QLOCK_ADAPTIVE;
+  printf("Lock inválido: %s (use tas, ticket, mcs, clh ou adaptive). Abortando...\n", spec);
+  exit(1);
+}
+
+const char* qlockName(int kind){
+  switch(kind){
+    case QLOCK_TAS: return "tas";
+    case QLOCK_TICKET: return "ticket";
+    case QLOCK_MCS: return "mcs";
+    case QLOCK_CLH: return "clh";
+    default: return "adaptive";
+  }
+}
+
+static qnode_t* newNode(){
+  qnode_t* node = aligned_alloc(CACHE_LINE, sizeof(qnode_t));
+
+  node->next = NULL;
+  node->locked = FALSE;
+  return node;
+}
+
+void qlockInit(qlock_t* l, int kind){
+  memset(l, 0, sizeof(qlock_t));
+  l->kind = kind;
+  // o CLH começa com um nó livre na fila, de ninguém
+  if(kind == QLOCK_CLH)
+    l->tail = newNode();
+}
+
+void qlockThreadInit(int tid){
+  if(tid < QLOCK_MAX_THREADS)
+    self = &qlock_stats[tid];
+}
+
+/* Pega um slot livre da thread para o lock que vai esperar */
+static int takeSlot(){
+  int i;
+
+  for(i = 0; i < QLOCK_NESTING; i++){
+    if(!my_used[i]){
+      if(my_nodes[i] == NULL)
+        my_nodes[i] = newNode();
+      my_used[i] = TRUE;
+      return i;
+    }
+  }
+  printf("Mais de %d locks segurados ao mesmo tempo. Abortando...\n", QLOCK_NESTING);
+  exit(1);
+}
+
+static int findSlot(qnode_t* node){
+  int i;
+
+  for(i = 0; i < QLOCK_NESTING; i++)
+    if(my_used[i] && my_nodes[i] == node)
+      return i;
+  return -1;
+}
+
+/* Uma volta de espera; cede a CPU de vez em quando */
+static void spinOnce(int* spins){
+  cpuRelax();
+  if(++(*spins) == QLOCK_SPINS){
+    *spins = 0;
+    sched_yield();
+  }
+}
+
+// called after a wait that had to spin; the handoff only counts if the
+// previous owner stamped it after we started waiting (TAS never stamps)
+static void countWait(qlock_t* l, long start){
+  long now, released;
+
+  if(self == NULL)
+    return;
+  now = nowNs();
+  released = __atomic_load_n(&l->release_ns, __ATOMIC_RELAXED);
+  self->contended++;
+  self->wait_ns += now - start;
+  if(released >= start){
+    self->handoffs++;
+    self->handoff_ns += now - released;
+    if(now - released > self->handoff_max)
+      self->handoff_max = now - released;
+  }
+}
+
+// stamps the handoff before the store that passes the lock on
+static void stampRelease(qlock_t* l){
+  __atomic_store_n(&l->release_ns, nowNs(), __ATOMIC_RELAXED);
+}
+
+static long futexWait(int* addr, int val){
+  return syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, val, NULL, NULL, 0);
+}
+
+static long futexWake(int* addr, int n){
+  return syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, n, NULL, NULL, 0);
+}
+
+// spin with exponential backoff for about twice the recent average hold
+// time, then park; state 2 tells the holder that someone may be asleep
+static void adaptiveAcquire(qlock_t* l, long* start){
+  long hold = __atomic_load_n(&l->hold_avg, __ATOMIC_RELAXED);
+  long budget = hold * 2;
+  long t0 = cycles();
+  int backoff = 1;
+  int expected, i;
+
+  *start = nowNs();
+  if(budget > QLOCK_MAX_SPIN)
+    budget = QLOCK_MIN_SPIN;
+  else if(budget < QLOCK_MIN_SPIN)
+    budget = QLOCK_MIN_SPIN;
+
+  while(cycles() - t0 < budget){
+    for(i = 0; i < backoff; i++)
+      cpuRelax();
+    if(backoff < QLOCK_MAX_BACKOFF)
+      backoff *= 2;
+
+    expected = 0;
+    if(__atomic_load_n(&l->state, __ATOMIC_RELAXED) == 0 &&
+       __atomic_compare_exchange_n(&l->state, &expected, 1, 0,
+                                   __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+      return;
+  }
+
+  // we cannot tell whether other sleepers remain, so keep 2 once woken
+  while(__atomic_exchange_n(&l->state, 2, __ATOMIC_ACQUIRE) != 0){
+    if(self != NULL)
+      self->parks++;
+    futexWait(&l->state, 2);
+  }
+}
+
+void qlockAcquire(qlock_t* l){
+  long start = 0;
+  int spins = 0;
+
+  switch(l->kind){
+    case QLOCK_TAS:
+      while(__atomic_exchange_n(&l->state, TRUE, __ATOMIC_ACQUIRE)){
+        if(start == 0)
+          start = nowNs();
+        while(__atomic_load_n(&l->state, __ATOMIC_RELAXED))
+          spinOnce(&spins);
+      }
+      break;
+
+    case QLOCK_ADAPTIVE: {
+      int expected = 0;
+
+      if(!__atomic_compare_exchange_n(&l->state, &expected, 1, 0,
+                                      __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        adaptiveAcquire(l, &start);
+      l->hold_start = cycles();
+      break;
+    }
+
+    case QLOCK_TICKET: {
+      unsigned int ticket = __atomic_fetch_add(&l->next, 1, __ATOMIC_RELAXED);
+      unsigned int serving;
+
+      while((serving = LOAD(&l->serving)) != ticket){
+        int i;
+
+        if(start == 0)
+          start = nowNs();
+        for(i = 0; i < (int) (ticket - serving) * QLOCK_TICKET_BACKOFF; i++)
+          spinOnce(&spins);
+      }
+      break;
+    }
+
+    case QLOCK_MCS: {
+      qnode_t* me = my_nodes[takeSlot()];
+      qnode_t* pred;
+
+      me->next = NULL;
+      me->locked = TRUE;
+      pred = __atomic_exchange_n(&l->tail, me, __ATOMIC_ACQ_REL);
+      if(pred != NULL){
+        start = nowNs();
+        STORE(&pred->next, me);
+        while(LOAD(&me->locked))
+          spinOnce(&spins);
+      }
+      l->holder = me;
+      break;
+    }
+
+    case QLOCK_CLH: {
+      qnode_t* me = my_nodes[takeSlot()];
+      qnode_t* pred;
+
+      me->locked = TRUE;
+      pred = __atomic_exchange_n(&l->tail, me, __ATOMIC_ACQ_REL);
+      while(LOAD(&pred->locked)){
+        if(start == 0)
+          start = nowNs();
+        spinOnce(&spins);
+      }
+      l->holder = me;
+      l->pred = pred;
+      break;
+    }
+  }
+
+  if(self != NULL)
+    self->acquires++;
+  if(start != 0)
+    countWait(l, start);
+}
+
+void qlockRelease(qlock_t* l){
+  switch(l->kind){
+    case QLOCK_TAS:
+      __atomic_store_n(&l->state, FALSE, __ATOMIC_RELEASE);
+      break;
+
+    case QLOCK_ADAPTIVE: {
+      long hold = cycles() - l->hold_start;
+      long avg = __atomic_load_n(&l->hold_avg, __ATOMIC_RELAXED);
+
+      // média móvel com peso 1/8 para a última posse
+      __atomic_store_n(&l->hold_avg, avg + (hold - avg) / 8, __ATOMIC_RELAXED);
+      if(__atomic_load_n(&l->state, __ATOMIC_RELAXED) == 2)
+        stampRelease(l);
+      if(__atomic_exchange_n(&l->state, 0, __ATOMIC_RELEASE) == 2)
+        futexWake(&l->state, 1);
+      break;
+    }
+
+    case QLOCK_TICKET:
+      if(__atomic_load_n(&l->next, __ATOMIC_RELAXED) != l->serving + 1)
+        stampRelease(l);
+      STORE(&l->serving, l->serving + 1);
+      break;
+
+    case QLOCK_MCS: {
+      qnode_t* me = l->holder;
+      qnode_t* succ = LOAD(&me->next);
+
+      if(succ == NULL){
+        qnode_t* expected = me;
+
+        // nobody behind us: empty the queue
+        if(__atomic_compare_exchange_n(&l->tail, &expected, NULL, 0,
+                                       __ATOMIC_RELEASE, __ATOMIC_RELAXED)){
+          my_used[findSlot(me)] = FALSE;
+          return;
+        }
+        // someone swapped the tail but has not linked itself yet
+        while((succ = LOAD(&me->next)) == NULL)
+          cpuRelax();
+      }
+      stampRelease(l);
+      my_used[findSlot(me)] = FALSE;
+      STORE(&succ->locked, FALSE);
+      break;
+    }
+
+    case QLOCK_CLH: {
+      qnode_t* me = l->holder;
+      int slot = findSlot(me);
+
+      if(__atomic_load_n(&l->tail, __ATOMIC_RELAXED) != me)
+        stampRelease(l);
+      // our successor spins on me; the predecessor's node is ours from now on
+      my_nodes[slot] = l->pred;
+      my_used[slot] = FALSE;
+      STORE(&me->locked, FALSE);
+      break;
+    }
+  }
+}
+
+void qlockPrintStats(int n_threads){
+  long acquires = 0, contended = 0, handoffs = 0, max = 0, parks = 0;
+  long min_acq = -1, max_acq = 0;
+  double wait = 0, handoff = 0, sum_sq = 0;
+  int i;
+
+  if(n_threads > QLOCK_MAX_THREADS)
+    n_threads = QLOCK_MAX_THREADS;
+
+  for(i = 0; i < n_threads; i++){
+    qlock_stats_t* s = &qlock_stats[i];
+
+    acquires += s->acquires;
+    contended += s->contended;
+    wait += s->wait_ns;
+    handoffs += s->handoffs;
+    parks += s->parks;
+    handoff += s->handoff_ns;
+    if(s->handoff_max > max)
+      max = s->handoff_max;
+    if(min_acq < 0 || s->acquires < min_acq)
+      min_acq = s->acquires;
+    if(s->acquires > max_acq)
+      max_acq = s->acquires;
+    sum_sq += (double) s->acquires * s->acquires;
+  }
+
+  if(acquires == 0)
+    return;
+
+  printf("Lock: %ld aquisições, %.1f%% com espera", acquires, 100.0 * contended / acquires);
+  if(contended > 0)
+    printf(" (média %.0lf ns)", wait / contended);
+  printf("\n");
+  if(parks > 0)
+    printf("Dormiram no futex: %ld vezes\n", parks);
+  if(handoffs > 0)
+    printf("Repasse do lock: média %.0lf ns, máximo %ld ns em %ld repasses medidos\n",
+           handoff / handoffs, max, handoffs);
+  // índice de Jain: 1 quando todas as threads pegam o lock o mesmo número de vezes
+  printf("Justiça: índice de Jain %.3f, aquisições por thread entre %ld e %ld\n",
+         (double) acquires * acquires / (n_threads * sum_sq), min_acq, max_acq);
+}
@@ -0,0 +1,69 @@
+#ifndef QLOCK_H
+#define QLOCK_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef CACHE_LINE
+#define CACHE_LINE 64
+#endif
+
+/* Tipos de lock */
+#define QLOCK_TAS 0                // test-and-test-and-set, a base de comparação
+#define QLOCK_TICKET 1             // fila FIFO por senha; todos esperam no mesmo contador
+#define QLOCK_MCS 2                // fila encadeada, cada um espera no próprio nó
+#define QLOCK_CLH 3                // fila implícita, cada um espera no nó do antecessor
+#define QLOCK_ADAPTIVE 4           // gira com backoff por um tempo aprendido, depois dorme no futex
+
+/* Locks segurados ao mesmo tempo por uma thread (MCS e CLH usam um nó cada) */
+#define QLOCK_NESTING 8
+
+/* Threads com estatísticas; as que não chamam qlockThreadInit não contam */
+#define QLOCK_MAX_THREADS 1024
+
+/* Nó de espera de MCS e CLH, cada um na sua linha de cache */
+typedef struct qnode_t{
+  struct qnode_t* next;         // MCS: sucessor na fila
+  int locked;                   // TRUE enquanto o dono do nó tem ou espera o lock
+} __attribute__((aligned(CACHE_LINE))) qnode_t;
+
+typedef struct qlock_t{
+  int kind;
+  int state;                    // TAS e adaptive: 0 livre, 1 ocupado, 2 ocupado com alguém dormindo
+  unsigned int next;            // ticket: próxima senha
+  unsigned int serving;         // ticket: senha atendida
+  qnode_t* tail;                // MCS e CLH: último da fila
+  qnode_t* holder;              // MCS e CLH: nó de quem tem o lock, só ele mexe
+  qnode_t* pred;                // CLH: nó do antecessor, reaproveitado na saída
+  long release_ns;              // quando o último dono passou o lock adiante
+  long hold_avg;                // adaptive: média móvel do tempo com o lock, em ciclos
+  long hold_start;              // adaptive: quando o dono atual pegou o lock
+} __attribute__((aligned(CACHE_LINE))) qlock_t;
+
+/* Contadores de uma thread */
+typedef struct qlock_stats_t{
+  long acquires;
+  long contended;               // aquisições que tiveram que esperar
+  double wait_ns;
+  long handoffs;                // esperas que terminaram com um repasse medido
+  double handoff_ns;            // do unlock do dono anterior até a volta da espera
+  long handoff_max;
+  long parks;                   // adaptive: vezes que dormiu no futex
+} __attribute__((aligned(CACHE_LINE))) qlock_stats_t;
+
+/* Lê o nome do tipo (tas, ticket, mcs, clh ou adaptive), aborta se for inválido */
+int qlockKind(const char* spec);
+
+const char* qlockName(int kind);
+
+void qlockInit(qlock_t* l, int kind);
+
+/* Associa a thread corrente às estatísticas tid */
+void qlockThreadInit(int tid);
+
+void qlockAcquire(qlock_t* l);
+
+void qlockRelease(qlock_t* l);
+
+void qlockPrintStats(int n_threads);
+#endif
@@ -0,0 +1,247 @@
+/* STM no estilo TL2: relógio global de versões e uma tabela de locks     */
+/* versionados, cada um cobrindo as palavras que caem na sua faixa. As    */
+/* leituras conferem a versão contra o relógio do início e entram no      */
+/* conjunto de leitura; as escritas ficam num buffer até o commit, que    */
+/* trava o conjunto de escrita, valida as leituras e publica tudo com a   */
+/* nova versão. Conta commits, aborts por causa e o tamanho dos conjuntos */
+
+#include <string.h>
+#include <sched.h>
+#include "STM.h"
+
+#define LOAD(addr) __atomic_load_n((addr), __ATOMIC_ACQUIRE)
+#define STORE(addr, v) __atomic_store_n((addr), (v), __ATOMIC_RELEASE)
+
+/* Aborts seguidos antes de ceder a CPU em vez de só esperar */
+#define STM_YIELD_RETRIES 8
+
+static uintptr_t stm_clock __attribute__((aligned(CACHE_LINE))) = 0;
+static uintptr_t stm_locks[STM_LOCKS] __attribute__((aligned(CACHE_LINE)));
+static stm_stats_t stm_stats[STM_MAX_THREADS];
+
+static __thread stm_tx_t* self = NULL;
+static __thread stm_stats_t unregistered;
+
+/* Lock versionado da palavra: livre guarda versão << 1, travado guarda o
+   endereço do descritor dono com o bit 0 ligado */
+static inline uintptr_t* lockOf(void* addr){
+  return &stm_locks[((uintptr_t) addr >> 3) & (STM_LOCKS - 1)];
+}
+
+static inline uint64_t bloomBit(void* addr){
+  return 1ULL << (((uintptr_t) addr >> 3) & 63);
+}
+
+stm_tx_t* stmSelf(){
+  if(self == NULL){
+    self = aligned_alloc(CACHE_LINE, (sizeof(stm_tx_t) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE);
+    memset(self, 0, sizeof(stm_tx_t));
+    self->cap_reads = 64;
+    self->reads = malloc(sizeof(uintptr_t*) * self->cap_reads);
+    self->cap_writes = 16;
+    self->writes = malloc(sizeof(stm_write_t) * self->cap_writes);
+    self->locked = malloc(sizeof(stm_locked_t) * self->cap_writes);
+    self->seed = (unsigned int) (uintptr_t) self;
+    self->stats = &unregistered;
+  }
+  return self;
+}
+
+void stmThreadInit(int tid){
+  if(tid < STM_MAX_THREADS)
+    stmSelf()->stats = &stm_stats[tid];
+}
+
+void stmStart(stm_tx_t* tx){
+  tx->n_reads = 0;
+  tx->n_writes = 0;
+  tx->n_locked = 0;
+  tx->filter = 0;
+  tx->rv = LOAD(&stm_clock);
+}
+
+// randomized exponential backoff, so two transactions that keep killing
+// each other get out of step; with more threads than CPUs, yield instead
+static void backoff(stm_tx_t* tx){
+  int limit, i, n;
+
+  if(tx->retries % STM_YIELD_RETRIES == 0){
+    sched_yield();
+    return;
+  }
+  limit = 16 << (tx->retries < 10 ? tx->retries : 10);
+  tx->seed = tx->seed * 1103515245 + 12345;
+  n = (tx->seed >> 8) % limit;
+  for(i = 0; i < n; i++)
+    __asm__ __volatile__("" ::: "memory");
+}
+
+void stmAbort(stm_tx_t* tx, int cause){
+  int i;
+
+  for(i = 0; i < tx->n_locked; i++)
+    STORE(tx->locked[i].lock, tx->locked[i].old);
+
+  tx->stats->aborts[cause]++;
+  tx->retries++;
+  backoff(tx);
+  siglongjmp(tx->env, 1);
+}
+
+uintptr_t stmRead(stm_tx_t* tx, void* addr, int size){
+  uintptr_t* lock;
+  uintptr_t v1, v2, val;
+  int i;
+
+  // read after write: the buffered value
+  if(tx->filter & bloomBit(addr)){
+    for(i = tx->n_writes - 1; i >= 0; i--)
+      if(tx->writes[i].addr == addr)
+        return tx->writes[i].val;
+  }
+
+  lock = lockOf(addr);
+  v1 = LOAD(lock);
+  if(size == 4)
+    val = __atomic_load_n((uint32_t*) addr, __ATOMIC_RELAXED);
+  else
+    val = __atomic_load_n((uint64_t*) addr, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  v2 = __atomic_load_n(lock, __ATOMIC_RELAXED);
+
+  if((v1 & 1) || (v2 & 1))
+    stmAbort(tx, STM_ABORT_LOCKED);
+  if(v1 != v2 || (v1 >> 1) > tx->rv)
+    stmAbort(tx, STM_ABORT_VERSION);
+
+  if(tx->n_reads == tx->cap_reads){
+    tx->cap_reads *= 2;
+    tx->reads = realloc(tx->reads, sizeof(uintptr_t*) * tx->cap_reads);
+  }
+  tx->reads[tx->n_reads++] = lock;
+  return val;
+}
+
+void stmWrite(stm_tx_t* tx, void* addr, uintptr_t val, int size){
+  int i;
+
+  if(tx->filter & bloomBit(addr)){
+    for(i = tx->n_writes - 1; i >= 0; i--){
+      if(tx->writes[i].addr == addr){
+        tx->writes[i].val = val;
+        return;
+      }
+    }
+  }
+
+  if(tx->n_writes == tx->cap_writes){
+    tx->cap_writes *= 2;
+    tx->writes = realloc(tx->writes, sizeof(stm_write_t) * tx->cap_writes);
+    tx->locked = realloc(tx->locked, sizeof(stm_locked_t) * tx->cap_writes);
+  }
+  tx->writes[tx->n_writes].addr = addr;
+  tx->writes[tx->n_writes].val = val;
+  tx->writes[tx->n_writes].size = size;
+  tx->n_writes++;
+  tx->filter |= bloomBit(addr);
+}
+
+/* Versão de antes do commit de um lock que esta transação travou */
+static uintptr_t lockedVersion(stm_tx_t* tx, uintptr_t* lock){
+  int i;
+
+  for(i = 0; i < tx->n_locked; i++)
+    if(tx->locked[i].lock == lock)
+      return tx->locked[i].old;
+  return 0;
+}
+
+void stmCommit(stm_tx_t* tx){
+  uintptr_t mine = (uintptr_t) tx | 1;
+  uintptr_t wv, v;
+  int i;
+
+  // read-only: every read was already checked against rv
+  if(tx->n_writes == 0){
+    tx->stats->commits++;
+    tx->stats->ro_commits++;
+    tx->stats->reads += tx->n_reads;
+    tx->retries = 0;
+    return;
+  }
+
+  for(i = 0; i < tx->n_writes; i++){
+    uintptr_t* lock = lockOf(tx->writes[i].addr);
+
+    v = LOAD(lock);
+    if(v == mine)
+      continue;
+    if((v & 1) || !__atomic_compare_exchange_n(lock, &v, mine, 0,
+                                              __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+      stmAbort(tx, STM_ABORT_COMMIT_LOCK);
+    tx->locked[tx->n_locked].lock = lock;
+    tx->locked[tx->n_locked].old = v;
+    tx->n_locked++;
+  }
+
+  wv = __atomic_add_fetch(&stm_clock, 1, __ATOMIC_ACQ_REL);
+
+  // nobody committed since we started: the read set is still valid
+  if(wv != tx->rv + 1){
+    for(i = 0; i < tx->n_reads; i++){
+      v = LOAD(tx->reads[i]);
+      if(v == mine)
+        v = lockedVersion(tx, tx->reads[i]);
+      else if(v & 1)
+        stmAbort(tx, STM_ABORT_VALIDATE);
+      if((v >> 1) > tx->rv)
+        stmAbort(tx, STM_ABORT_VALIDATE);
+    }
+  }
+
+  for(i = 0; i < tx->n_writes; i++){
+    if(tx->writes[i].size == 4)
+      __atomic_store_n((uint32_t*) tx->writes[i].addr, (uint32_t) tx->writes[i].val, __ATOMIC_RELAXED);
+    else
+      __atomic_store_n((uint64_t*) tx->writes[i].addr, (uint64_t) tx->writes[i].val, __ATOMIC_RELAXED);
+  }
+  for(i = 0; i < tx->n_locked; i++)
+    STORE(tx->locked[i].lock, wv << 1);
+
+  tx->stats->commits++;
+  tx->stats->reads += tx->n_reads;
+  tx->stats->writes += tx->n_writes;
+  tx->retries = 0;
+}
+
+void stmPrintStats(int n_threads){
+  stm_stats_t total;
+  long aborts = 0;
+  int i, c;
+
+  memset(&total, 0, sizeof(total));
+  if(n_threads > STM_MAX_THREADS)
+    n_threads = STM_MAX_THREADS;
+
+  for(i = 0; i < n_threads; i++){
+    total.commits += stm_stats[i].commits;
+    total.ro_commits += stm_stats[i].ro_commits;
+    total.reads += stm_stats[i].reads;
+    total.writes += stm_stats[i].writes;
+    for(c = 0; c < STM_ABORT_CAUSES; c++)
+      total.aborts[c] += stm_stats[i].aborts[c];
+  }
+  for(c = 0; c < STM_ABORT_CAUSES; c++)
+    aborts += total.aborts[c];
+
+  if(total.commits == 0)
+    return;
+
+  printf("STM: %ld commits (%ld só leitura), %ld aborts (%.3f por commit)\n",
+         total.commits, total.ro_commits, aborts, (double) aborts / total.commits);
+  printf("Aborts por causa: leitura travada %ld, leitura nova demais %ld, lock no commit %ld, validação %ld\n",
+         total.aborts[STM_ABORT_LOCKED], total.aborts[STM_ABORT_VERSION],
+         total.aborts[STM_ABORT_COMMIT_LOCK], total.aborts[STM_ABORT_VALIDATE]);
+  printf("Conjuntos por transação confirmada: %.1f leituras, %.1f escritas\n",
+         (double) total.reads / total.commits, (double) total.writes / total.commits);
+}
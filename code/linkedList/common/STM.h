@@ -0,0 +1,86 @@
+#ifndef STM_H
+#define STM_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <setjmp.h>
+
+#ifndef CACHE_LINE
+#define CACHE_LINE 64
+#endif
+
+/* Locks versionados: um para cada palavra de 8 bytes que cai na faixa */
+#define STM_LOCKS (1 << 20)
+
+/* Threads com estatísticas; as que não chamam stmThreadInit não contam */
+#define STM_MAX_THREADS 1024
+
+/* Causas de abort */
+#define STM_ABORT_LOCKED 0         // leitura de uma palavra travada por um commit
+#define STM_ABORT_VERSION 1        // leitura de uma palavra mais nova que o início
+#define STM_ABORT_COMMIT_LOCK 2    // não conseguiu travar o conjunto de escrita
+#define STM_ABORT_VALIDATE 3       // o conjunto de leitura mudou antes do commit
+#define STM_ABORT_CAUSES 4
+
+typedef struct stm_write_t{
+  void* addr;
+  uintptr_t val;
+  int size;                     // 4 ou 8 bytes
+} stm_write_t;
+
+typedef struct stm_locked_t{
+  uintptr_t* lock;
+  uintptr_t old;                // versão antes de travar, volta no abort
+} stm_locked_t;
+
+typedef struct stm_stats_t{
+  long commits;
+  long ro_commits;              // sem escritas, sem validação no fim
+  long aborts[STM_ABORT_CAUSES];
+  long reads;                   // tamanho dos conjuntos das transações confirmadas
+  long writes;
+} __attribute__((aligned(CACHE_LINE))) stm_stats_t;
+
+/* Descritor da transação, um por thread */
+typedef struct stm_tx_t{
+  sigjmp_buf env;               // volta para o TM_BEGIN no abort
+  uintptr_t rv;                 // relógio global no início
+  uintptr_t** reads;            // locks lidos
+  int n_reads, cap_reads;
+  stm_write_t* writes;
+  int n_writes, cap_writes;
+  uint64_t filter;              // bloom dos endereços escritos, evita varrer writes
+  stm_locked_t* locked;
+  int n_locked;
+  int retries;                  // aborts seguidos, para o backoff
+  unsigned int seed;
+  stm_stats_t* stats;           // o de uma thread sem registro não é somado
+} stm_tx_t;
+
+/* Transação com rollback por longjmp: variáveis locais alteradas dentro
+   dela e lidas depois de um abort precisam ser reatribuídas no começo.
+   Tamanhos misturados na mesma palavra (int e ponteiro sobrepostos) não
+   são suportados */
+#define TM_BEGIN() do{ stm_tx_t* _tx = stmSelf(); sigsetjmp(_tx->env, 0); stmStart(_tx);
+#define TM_END() stmCommit(_tx); }while(0)
+#define TM_READ(addr) ((__typeof__(*(addr))) stmRead(_tx, (void*) (addr), sizeof(*(addr))))
+#define TM_WRITE(addr, v) stmWrite(_tx, (void*) (addr), (uintptr_t) (v), sizeof(*(addr)))
+
+stm_tx_t* stmSelf();
+
+/* Associa a thread corrente às estatísticas tid */
+void stmThreadInit(int tid);
+
+void stmStart(stm_tx_t* tx);
+
+uintptr_t stmRead(stm_tx_t* tx, void* addr, int size);
+
+void stmWrite(stm_tx_t* tx, void* addr, uintptr_t val, int size);
+
+void stmCommit(stm_tx_t* tx);
+
+void stmAbort(stm_tx_t* tx, int cause);
+
+void stmPrintStats(int n_threads);
+#endif
@@ -0,0 +1,134 @@
+/* Arena de memória compartilhada entre processos                        */
+/* Uma única região memfd mapeada com MAP_SHARED antes do fork, no lugar */
+/* de um segmento SysV para cada estrutura: os filhos herdam o mapeamento */
+/* no mesmo endereço, então ponteiros para dentro dela valem em todos.   */
+/* Opcionalmente usa páginas grandes e faz o prefault na criação, o que  */
+/* tira as faltas de página e boa parte das falhas de TLB da medição.    */
+/* Depois do fork ela ainda pode crescer: o memfd é estendido e cada     */
+/* processo mapeia a parte nova quando a encontra                        */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "ShArena.h"
+
+#define TRUE 1
+#define FALSE 0
+
+/* Tamanho da página grande padrão do x86-64; se o sistema usar outro,
+   o ftruncate do hugetlbfs falha e a arena cai para THP */
+#define HUGE_PAGE (2UL << 20)
+
+arena_t arena = { -1, NULL, 0, 0, 0, ARENA_PAGES_NORMAL, 0 };
+
+static size_t roundUp(size_t size, size_t page){
+  return (size + page - 1) / page * page;
+}
+
+/* Cria o memfd e o mapeia; devolve FALSE sem abortar para permitir o fallback */
+static int mapArena(size_t size, unsigned int mfd_flags){
+  arena.fd = memfd_create("linkedList", mfd_flags);
+  if(arena.fd < 0)
+    return FALSE;
+
+  if(ftruncate(arena.fd, size) < 0){
+    close(arena.fd);
+    return FALSE;
+  }
+
+  arena.base = (char*) mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, arena.fd, 0);
+  if(arena.base == MAP_FAILED){
+    close(arena.fd);
+    return FALSE;
+  }
+
+  arena.size = size;
+  return TRUE;
+}
+
+// uma leitura por página já basta: no memfd a falta de leitura aloca a
+// página e a mapeia para escrita; escrever apagaria nós de outro processo
+static void prefault(char* p, size_t size){
+  size_t off;
+
+  if(arena.flags & ARENA_PREFAULT){
+    for(off = 0; off < size; off += arena.page)
+      (void) *(volatile char*) (p + off);
+  }
+}
+
+void arenaCreate(size_t size, int flags){
+  long page = sysconf(_SC_PAGESIZE);
+
+  arena.flags = flags;
+  arena.used = 0;
+
+  if((flags & ARENA_HUGEPAGES) && mapArena(roundUp(size, HUGE_PAGE), MFD_HUGETLB)){
+    arena.pages = ARENA_PAGES_HUGETLB;
+    arena.page = HUGE_PAGE;
+  } else {
+    if(!mapArena(roundUp(size, page), 0)){
+      printf("Não foi possível criar a arena de memória compartilhada. Abortando...\n");
+      exit(1);
+    }
+
+    arena.pages = ARENA_PAGES_NORMAL;
+    arena.page = page;
+    if((flags & ARENA_HUGEPAGES) && madvise(arena.base, arena.size, MADV_HUGEPAGE) == 0)
+      arena.pages = ARENA_PAGES_THP;
+  }
+
+  prefault(arena.base, arena.size);
+}
+
+void* arenaCarve(size_t size){
+  char* p = arena.base + arena.used;
+
+  size = ARENA_ALIGN(size);
+  if(arena.used + size > arena.size){
+    printf("Arena de memória compartilhada pequena demais. Abortando...\n");
+    exit(1);
+  }
+  arena.used += size;
+  return p;
+}
+
+void arenaExtend(size_t offset, size_t size){
+  if(fallocate(arena.fd, 0, offset, size) < 0){
+    printf("Não foi possível aumentar a arena de memória compartilhada. Abortando...\n");
+    exit(1);
+  }
+}
+
+void* arenaMap(size_t offset, size_t size){
+  char* p;
+
+  p = (char*) mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, arena.fd, offset);
+  if(p == MAP_FAILED){
+    printf("Não foi possível mapear a parte nova da arena. Abortando...\n");
+    exit(1);
+  }
+  if(arena.pages == ARENA_PAGES_THP)
+    madvise(p, size, MADV_HUGEPAGE);
+
+  // cada processo toca as páginas no próprio mapeamento, fora das operações
+  prefault(p, size);
+  return p;
+}
+
+// o tamanho vem do memfd, que inclui o que os filhos acrescentaram
+void arenaPrintInfo(){
+  const char* pages[] = { "normais", "grandes (hugetlbfs)", "grandes (THP pedido com madvise)" };
+  struct stat st;
+
+  if(fstat(arena.fd, &st) < 0)
+    st.st_size = arena.size;
+  printf("Memória compartilhada: %.2lf MB numa arena memfd, páginas %s%s\n",
+         st.st_size / (1024.0 * 1024.0), pages[arena.pages],
+         (arena.flags & ARENA_PREFAULT) ? ", com prefault" : "");
+}
@@ -0,0 +1,51 @@
+#ifndef SHARENA_H
+#define SHARENA_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef CACHE_LINE
+#define CACHE_LINE 64
+#endif
+
+/* Opções da arena */
+#define ARENA_HUGEPAGES 1          // páginas grandes: hugetlbfs, ou THP se não houver páginas reservadas
+#define ARENA_PREFAULT 2           // toca todas as páginas na criação
+
+/* Páginas que a arena conseguiu */
+#define ARENA_PAGES_NORMAL 0
+#define ARENA_PAGES_HUGETLB 1
+#define ARENA_PAGES_THP 2          // só um pedido (madvise), o kernel pode ignorar
+
+/* Tamanho de uma parte da arena, arredondado para começar a próxima numa linha de cache */
+#define ARENA_ALIGN(size) (((size) + CACHE_LINE - 1) & ~((size_t) CACHE_LINE - 1))
+
+typedef struct arena_t{
+  int fd;                       // memfd, herdado pelos filhos do fork
+  char* base;
+  size_t size;                  // mapeado na criação, arredondado para a página usada
+  size_t used;
+  size_t page;                  // tamanho da página usada
+  int flags;
+  int pages;
+} arena_t;
+
+extern arena_t arena;
+
+/* Cria a arena compartilhada; deve ser chamada antes do fork */
+void arenaCreate(size_t size, int flags);
+
+/* Reserva uma parte alinhada à linha de cache, zerada; só antes do fork */
+void* arenaCarve(size_t size);
+
+/* Garante a parte [offset, offset + size) do memfd (múltiplos de page).
+   Nunca encolhe o arquivo, então processos podem crescer a arena ao mesmo
+   tempo e em qualquer ordem */
+void arenaExtend(size_t offset, size_t size);
+
+/* Mapeia neste processo a parte [offset, offset + size) do memfd, que
+   outro processo pode ter criado com arenaExtend */
+void* arenaMap(size_t offset, size_t size);
+
+void arenaPrintInfo();
+#endif
@@ -0,0 +1,167 @@
+/* Timer da execução                                                     */
+/* Uma thread separada dorme até o fim da duração e então levanta a flag */
+/* stop, que os trabalhadores só leem; com -I ela também acorda a cada   */
+/* intervalo e guarda as operações acumuladas de cada thread, formando   */
+/* uma série de vazão ao longo da execução                               */
+
+#include <string.h>
+#include <sys/mman.h>
+#include "Timer.h"
+
+run_timer_t run_timer;
+
+static double elapsedMs(struct timespec* start, struct timespec* end){
+  return (end->tv_sec - start->tv_sec) * 1.0e3 + (end->tv_nsec - start->tv_nsec) * 1.0e-6;
+}
+
+static void addMs(struct timespec* t, double ms){
+  long ns = t->tv_nsec + (long) (ms * 1.0e6);
+
+  t->tv_sec += ns / 1000000000L;
+  t->tv_nsec = ns % 1000000000L;
+}
+
+static int before(struct timespec* a, struct timespec* b){
+  return a->tv_sec < b->tv_sec || (a->tv_sec == b->tv_sec && a->tv_nsec < b->tv_nsec);
+}
+
+/* Deve ser chamada antes das threads (ou do fork) */
+void timerInit(int n_threads, double duration, int interval_ms, const char* series_path){
+  size_t size = CACHE_LINE + sizeof(timer_slot_t) * n_threads;
+  char* shared;
+
+  shared = (char*) mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if(shared == MAP_FAILED){
+    printf("Não foi possível criar a memória do timer. Abortando...\n");
+    exit(1);
+  }
+  memset(shared, 0, size);
+
+  run_timer.stop = (int*) shared;
+  run_timer.slots = (timer_slot_t*) (shared + CACHE_LINE);
+  run_timer.n_threads = n_threads;
+  run_timer.duration = duration;
+  run_timer.interval_ms = interval_ms;
+  run_timer.series_path = series_path;
+  run_timer.n_samples = 0;
+  run_timer.started = 0;
+
+  // no modo tempo a série tem tamanho conhecido, então o timer não usa malloc
+  run_timer.cap_samples = 16;
+  if(interval_ms > 0 && duration > 0)
+    run_timer.cap_samples = (int) (duration * 1000 / interval_ms) + 2;
+  run_timer.samples = (long*) malloc(sizeof(long) * n_threads * run_timer.cap_samples);
+  run_timer.sample_ms = (double*) malloc(sizeof(double) * run_timer.cap_samples);
+}
+
+static void sample(double ms){
+  int i;
+
+  if(run_timer.n_samples == run_timer.cap_samples){
+    run_timer.cap_samples *= 2;
+    run_timer.samples = (long*) realloc(run_timer.samples,
+                                        sizeof(long) * run_timer.n_threads * run_timer.cap_samples);
+    run_timer.sample_ms = (double*) realloc(run_timer.sample_ms, sizeof(double) * run_timer.cap_samples);
+  }
+
+  for(i = 0; i < run_timer.n_threads; i++)
+    run_timer.samples[run_timer.n_samples * run_timer.n_threads + i] =
+      __atomic_load_n(&run_timer.slots[i].ops, __ATOMIC_RELAXED);
+  run_timer.sample_ms[run_timer.n_samples++] = ms;
+}
+
+static void* timerThread(void* arg){
+  struct timespec start, end, next, wake, now;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  end = next = start;
+  addMs(&end, run_timer.duration * 1000);
+  addMs(&next, run_timer.interval_ms);
+
+  while(!__atomic_load_n(run_timer.stop, __ATOMIC_RELAXED)){
+    if(run_timer.interval_ms > 0 && (run_timer.duration == 0 || before(&next, &end)))
+      wake = next;
+    else
+      wake = end;
+
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    if(run_timer.interval_ms > 0 && !before(&now, &next)){
+      sample(elapsedMs(&start, &now));
+      addMs(&next, run_timer.interval_ms);
+    }
+
+    if(run_timer.duration > 0 && !before(&now, &end))
+      __atomic_store_n(run_timer.stop, 1, __ATOMIC_RELAXED);
+  }
+
+  return NULL;
+}
+
+/* Sem duração nem intervalo não há o que cronometrar e nenhuma thread é criada */
+void timerStart(){
+  if(run_timer.duration == 0 && run_timer.interval_ms == 0)
+    return;
+
+  pthread_create(&run_timer.thread, NULL, timerThread, NULL);
+  run_timer.started = 1;
+}
+
+/* Chamada depois que os trabalhadores terminaram */
+void timerStop(){
+  __atomic_store_n(run_timer.stop, 1, __ATOMIC_RELAXED);
+  if(run_timer.started)
+    pthread_join(run_timer.thread, NULL);
+  run_timer.started = 0;
+}
+
+/* Vazão de cada intervalo em ops/s: total e por thread */
+void timerPrintSeries(){
+  FILE* out = stdout;
+  double prev_ms = 0, dt;
+  long total, prev, curr;
+  int s, i;
+
+  if(run_timer.interval_ms == 0)
+    return;
+
+  if(run_timer.series_path != NULL){
+    out = fopen(run_timer.series_path, "w");
+    if(out == NULL){
+      printf("Não foi possível criar o arquivo %s\n", run_timer.series_path);
+      return;
+    }
+  }
+  else
+    printf("Série de vazão (ops/s a cada %d ms):\n", run_timer.interval_ms);
+
+  fprintf(out, "tempo_ms,total");
+  for(i = 0; i < run_timer.n_threads; i++)
+    fprintf(out, ",t%d", i);
+  fprintf(out, "\n");
+
+  for(s = 0; s < run_timer.n_samples; s++){
+    dt = (run_timer.sample_ms[s] - prev_ms) / 1000;
+    total = 0;
+    for(i = 0; i < run_timer.n_threads; i++){
+      curr = run_timer.samples[s * run_timer.n_threads + i];
+      prev = s > 0 ? run_timer.samples[(s - 1) * run_timer.n_threads + i] : 0;
+      total += curr - prev;
+    }
+
+    fprintf(out, "%.1lf,%.0lf", run_timer.sample_ms[s], total / dt);
+    for(i = 0; i < run_timer.n_threads; i++){
+      curr = run_timer.samples[s * run_timer.n_threads + i];
+      prev = s > 0 ? run_timer.samples[(s - 1) * run_timer.n_threads + i] : 0;
+      fprintf(out, ",%.0lf", (curr - prev) / dt);
+    }
+    fprintf(out, "\n");
+    prev_ms = run_timer.sample_ms[s];
+  }
+
+  if(out != stdout){
+    fclose(out);
+    printf("Série de vazão gravada em %s\n", run_timer.series_path);
+  }
+}
@@ -0,0 +1,55 @@
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+
+#ifndef CACHE_LINE
+#define CACHE_LINE 64
+#endif
+
+/* Operações acumuladas de uma thread, cada uma na sua linha de cache */
+typedef struct timer_slot_t{
+  long ops;
+} __attribute__((aligned(CACHE_LINE))) timer_slot_t;
+
+typedef struct run_timer_t{
+  /* Mapeados com MAP_SHARED, valem também para os processos filhos */
+  int* stop;                    // lido pelos trabalhadores a cada operação
+  timer_slot_t* slots;
+
+  /* Daqui em diante só a thread do timer acessa */
+  int n_threads;
+  double duration;              // 0 no modo número de operações: o timer só amostra
+  int interval_ms;              // 0 sem série temporal
+  const char* series_path;      // NULL imprime a série na saída padrão
+  long* samples;                // n_samples linhas de n_threads contadores
+  double* sample_ms;
+  int n_samples;
+  int cap_samples;
+  int started;
+  pthread_t thread;
+} run_timer_t;
+
+extern run_timer_t run_timer;
+
+void timerInit(int n_threads, double duration, int interval_ms, const char* series_path);
+
+void timerStart();
+
+void timerStop();
+
+void timerPrintSeries();
+
+/* Condição do laço no modo tempo de execução */
+static inline int timerRunning(){
+  return !__atomic_load_n(run_timer.stop, __ATOMIC_RELAXED);
+}
+
+/* Publica o total de operações da thread para a série temporal */
+static inline void timerCount(int tid, long ops){
+  __atomic_store_n(&run_timer.slots[tid].ops, ops, __ATOMIC_RELAXED);
+}
+#endif
@@ -0,0 +1,233 @@
+/* Carga de trabalho da lista                                            */
+/* Sem trace as operações são sorteadas por um xorshift de cada thread,   */
+/* com as chaves na distribuição escolhida com -k; com um trace binário   */
+/* (gerado pelo tracegen) cada thread lê a sua sequência de (operação,    */
+/* chave) de um arquivo mapeado com mmap, sem sorteio na região medida    */
+
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "Workload.h"
+
+workload_cfg_t workload = { .dist = DIST_UNIFORM, .theta = 0.99, .hot_keys = 0.2, .hot_ops = 0.8 };
+
+static const char* dist_names[] = {"uniform", "zipf", "hotspot", "seq"};
+
+void workloadConfig(int datasetsize, float lookupPct, float insertPct){
+  workload.datasetsize = datasetsize;
+  workload.lookupPct = lookupPct;
+  workload.insertPct = insertPct;
+}
+
+/* Lê a distribuição das chaves: uniform, zipf[:theta], hotspot[:chaves[:ops]] ou seq */
+void workloadDist(const char* spec){
+  const char* param = strchr(spec, ':');
+  size_t len = param != NULL ? (size_t) (param - spec) : strlen(spec);
+  int i;
+
+  for(i = 0; i < 4; i++){
+    if(strlen(dist_names[i]) == len && strncmp(spec, dist_names[i], len) == 0)
+      break;
+  }
+
+  if(i == 4){
+    printf("Distribuição de chaves desconhecida: %s. Abortando...\n", spec);
+    exit(1);
+  }
+  workload.dist = i;
+
+  if(param != NULL && i == DIST_ZIPF)
+    workload.theta = atof(param + 1);
+
+  if(param != NULL && i == DIST_HOTSPOT){
+    workload.hot_keys = atof(param + 1);
+    param = strchr(param + 1, ':');
+    if(param != NULL)
+      workload.hot_ops = atof(param + 1);
+  }
+
+  if(workload.theta <= 0 || workload.theta >= 1 ||
+     workload.hot_keys <= 0 || workload.hot_keys > 1 ||
+     workload.hot_ops < 0 || workload.hot_ops > 1){
+    printf("Parâmetros da distribuição de chaves inválidos: %s. Abortando...\n", spec);
+    exit(1);
+  }
+}
+
+/* Constantes do zipf; o zeta(n) custa O(n), então é calculado uma vez */
+static void zipfInit(){
+  double zeta_2 = 1.0 + pow(0.5, workload.theta);
+  double n = workload.datasetsize;
+  long i;
+
+  workload.zeta_n = 0;
+  for(i = 1; i <= workload.datasetsize; i++)
+    workload.zeta_n += 1.0 / pow((double) i, workload.theta);
+
+  workload.alpha = 1.0 / (1.0 - workload.theta);
+  workload.eta = (1.0 - pow(2.0 / n, 1.0 - workload.theta)) / (1.0 - zeta_2 / workload.zeta_n);
+}
+
+/* Mapeia e valida o trace; aborta o programa se o arquivo for inválido */
+const trace_header_t* workloadOpenTrace(const char* path){
+  struct stat st;
+  trace_header_t* h;
+  int fd;
+
+  fd = open(path, O_RDONLY);
+  if(fd < 0 || fstat(fd, &st) < 0){
+    printf("Não foi possível abrir o trace %s\n", path);
+    exit(1);
+  }
+
+  if((size_t) st.st_size < sizeof(trace_header_t)){
+    printf("Trace %s inválido: arquivo muito pequeno\n", path);
+    exit(1);
+  }
+
+  h = (trace_header_t*) mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(h == MAP_FAILED){
+    printf("Não foi possível mapear o trace %s\n", path);
+    exit(1);
+  }
+
+  if(memcmp(h->magic, TRACE_MAGIC, 4) != 0 || h->version != TRACE_VERSION){
+    printf("Trace %s inválido: cabeçalho desconhecido\n", path);
+    exit(1);
+  }
+
+  if(h->n_threads == 0 || h->ops_per_thread == 0 ||
+     (size_t) st.st_size != sizeof(trace_header_t) +
+                            sizeof(uint32_t) * h->n_threads * h->ops_per_thread){
+    printf("Trace %s inválido: tamanho não confere com o cabeçalho\n", path);
+    exit(1);
+  }
+
+  // o replay é uma leitura sequencial por thread
+  madvise(h, st.st_size, MADV_SEQUENTIAL);
+  madvise(h, st.st_size, MADV_WILLNEED);
+
+  workload.trace = h;
+  workload.trace_size = st.st_size;
+
+  return h;
+}
+
+/* Chamada pelo main depois do getArgs; com trace, o tamanho e as
+   porcentagens do programa passam a ser os do cabeçalho */
+void workloadInit(const char* trace_path, int* datasetsize, float* lookupPct, float* insertPct){
+  const trace_header_t* h;
+
+  if(trace_path != NULL){
+    h = workloadOpenTrace(trace_path);
+    *datasetsize = h->datasetsize;
+    *lookupPct = h->lookupPct;
+    *insertPct = h->insertPct;
+    workload.dist = h->dist;
+    workload.theta = h->theta;
+    workload.hot_keys = h->hot_keys;
+    workload.hot_ops = h->hot_ops;
+  }
+
+  workloadConfig(*datasetsize, *lookupPct, *insertPct);
+  if(workload.dist == DIST_ZIPF && workload.trace == NULL)
+    zipfInit();
+}
+
+void workloadPrintInfo(){
+  printf("\nDistribuição das chaves: %s", dist_names[workload.dist]);
+  if(workload.dist == DIST_ZIPF)
+    printf(" (theta = %.2lf)", workload.theta);
+  else if(workload.dist == DIST_HOTSPOT)
+    printf(" (%.0lf%% das operações em %.0lf%% das chaves)",
+           workload.hot_ops * 100, workload.hot_keys * 100);
+
+  if(workload.trace != NULL)
+    printf("\nTrace: replay de %lu operações por thread",
+           (unsigned long) workload.trace->ops_per_thread);
+}
+
+/* Semente do xorshift da thread; o splitmix64 espalha sementes próximas */
+static void seedThread(workload_t* w, uint64_t seed, int tid){
+  uint64_t z = seed + (uint64_t) (tid + 1) * 0x9E3779B97F4A7C15ULL;
+
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  w->rng = z ^ (z >> 31);
+  if(w->rng == 0)
+    w->rng = 1;
+
+  // cada thread começa os inserts sequenciais num ponto diferente
+  w->next_key = workloadRange(w, workload.datasetsize);
+}
+
+/* Inicializa a fonte de operações da thread tid */
+void workloadThread(workload_t* w, int tid){
+  const uint32_t* ops;
+
+  w->pos = 0;
+  if(workload.trace == NULL){
+    w->ops = NULL;
+    w->n_ops = 0;
+    seedThread(w, time(NULL), tid);
+    return;
+  }
+
+  ops = (const uint32_t*) (workload.trace + 1);
+  w->n_ops = workload.trace->ops_per_thread;
+  w->ops = ops + (long) (tid % workload.trace->n_threads) * w->n_ops;
+}
+
+/* Grava um trace com a configuração corrente; a semente de cada thread é
+   derivada de seed, então o mesmo seed gera o mesmo arquivo */
+void workloadWriteTrace(const char* path, int n_threads, long ops_per_thread, unsigned int seed){
+  trace_header_t h;
+  workload_t w;
+  uint32_t* buf;
+  int op, val, t;
+  long i;
+  FILE* f;
+
+  f = fopen(path, "wb");
+  if(f == NULL){
+    printf("Não foi possível criar o trace %s\n", path);
+    exit(1);
+  }
+
+  if(workload.dist == DIST_ZIPF)
+    zipfInit();
+
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, TRACE_MAGIC, 4);
+  h.version = TRACE_VERSION;
+  h.n_threads = n_threads;
+  h.datasetsize = workload.datasetsize;
+  h.ops_per_thread = ops_per_thread;
+  h.lookupPct = workload.lookupPct;
+  h.insertPct = workload.insertPct;
+  h.dist = workload.dist;
+  h.theta = workload.theta;
+  h.hot_keys = workload.hot_keys;
+  h.hot_ops = workload.hot_ops;
+  fwrite(&h, sizeof(h), 1, f);
+
+  buf = (uint32_t*) malloc(sizeof(uint32_t) * ops_per_thread);
+  w.ops = NULL;
+
+  for(t = 0; t < n_threads; t++){
+    seedThread(&w, seed, t);
+
+    for(i = 0; i < ops_per_thread; i++){
+      op = workloadNext(&w, &val);
+      buf[i] = TRACE_RECORD(op, val);
+    }
+    fwrite(buf, sizeof(uint32_t), ops_per_thread, f);
+  }
+
+  free(buf);
+  fclose(f);
+}
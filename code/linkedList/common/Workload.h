@@ -0,0 +1,183 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+
+#define OP_LOOKUP 0
+#define OP_INSERT 1
+#define OP_REMOVE 2
+
+/* Distribuições das chaves (-k) */
+#define DIST_UNIFORM 0
+#define DIST_ZIPF 1
+#define DIST_HOTSPOT 2
+#define DIST_SEQUENTIAL 3
+
+/* Cada operação do trace ocupa 32 bits: 2 bits de operação e 30 de chave */
+#define TRACE_KEY_BITS 30
+#define TRACE_KEY_MASK ((1u << TRACE_KEY_BITS) - 1)
+#define TRACE_OP(r) ((int) ((r) >> TRACE_KEY_BITS))
+#define TRACE_KEY(r) ((int) ((r) & TRACE_KEY_MASK))
+#define TRACE_RECORD(op, key) (((uint32_t) (op) << TRACE_KEY_BITS) | ((uint32_t) (key) & TRACE_KEY_MASK))
+
+#define TRACE_MAGIC "LLTR"
+#define TRACE_VERSION 1
+
+/* Cabeçalho do arquivo, seguido de n_threads vetores de ops_per_thread registros */
+typedef struct trace_header_t{
+  char magic[4];
+  uint32_t version;
+  uint32_t n_threads;
+  uint32_t datasetsize;
+  uint64_t ops_per_thread;
+  float lookupPct;
+  float insertPct;
+  uint32_t dist;                // só informativo, as chaves já estão no trace
+  float theta;
+  float hot_keys;
+  float hot_ops;
+  char pad[16];
+} trace_header_t;
+
+/* Fonte de operações de uma thread */
+typedef struct workload_t{
+  const uint32_t* ops;          // trace da thread, NULL sorteia com o gerador
+  long n_ops;
+  long pos;
+  uint64_t rng;                 // estado do xorshift64* da thread
+  uint32_t next_key;            // próxima chave dos inserts sequenciais
+} workload_t;
+
+/* Configuração compartilhada por todas as threads */
+typedef struct workload_cfg_t{
+  int datasetsize;
+  float lookupPct;
+  float insertPct;
+  int dist;
+  double theta;                 // zipf: expoente, 0 < theta < 1
+  double hot_keys;              // hotspot: fração das chaves que é quente
+  double hot_ops;               // hotspot: fração das operações nas chaves quentes
+  double zeta_n;                // constantes do zipf, calculadas no workloadInit
+  double alpha;
+  double eta;
+  const trace_header_t* trace;  // trace mapeado com mmap, NULL sem replay
+  size_t trace_size;
+} workload_cfg_t;
+
+extern workload_cfg_t workload;
+
+void workloadConfig(int datasetsize, float lookupPct, float insertPct);
+
+void workloadDist(const char* spec);
+
+void workloadInit(const char* trace_path, int* datasetsize, float* lookupPct, float* insertPct);
+
+void workloadPrintInfo();
+
+const trace_header_t* workloadOpenTrace(const char* path);
+
+void workloadThread(workload_t* w, int tid);
+
+void workloadWriteTrace(const char* path, int n_threads, long ops_per_thread, unsigned int seed);
+
+/* xorshift64*: estado só da thread, sem o lock interno do rand() */
+static inline uint64_t workloadRand(workload_t* w){
+  w->rng ^= w->rng >> 12;
+  w->rng ^= w->rng << 25;
+  w->rng ^= w->rng >> 27;
+  return w->rng * 0x2545F4914F6CDD1DULL;
+}
+
+/* Uniforme em [0, 1) */
+static inline double workloadUniform(workload_t* w){
+  return (workloadRand(w) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/* Uniforme em [0, n) sem divisão */
+static inline int workloadRange(workload_t* w, uint32_t n){
+  return (int) (((workloadRand(w) >> 32) * n) >> 32);
+}
+
+/* Zipf pelo método de Gray et al. (o mesmo do YCSB); o rank é espalhado
+   pelas chaves para que as quentes não fiquem todas no início da lista */
+static inline int workloadZipf(workload_t* w){
+  double u = workloadUniform(w);
+  double uz = u * workload.zeta_n;
+  uint64_t rank;
+
+  if(uz < 1.0)
+    rank = 0;
+  else if(uz < 1.0 + pow(0.5, workload.theta))
+    rank = 1;
+  else
+    rank = (uint64_t) (workload.datasetsize *
+                       pow(workload.eta * u - workload.eta + 1.0, workload.alpha));
+
+  if(rank >= (uint64_t) workload.datasetsize)
+    rank = workload.datasetsize - 1;
+
+  // 2654435761 é primo e maior que qualquer datasetsize: a multiplicação é uma permutação
+  return (int) ((rank * 2654435761ULL) % workload.datasetsize);
+}
+
+static inline int workloadKey(workload_t* w, int op){
+  uint32_t hot;
+  int key;
+
+  switch(workload.dist){
+    case DIST_ZIPF:
+      return workloadZipf(w);
+
+    case DIST_HOTSPOT:
+      // as chaves quentes são as hot_keys * datasetsize primeiras
+      hot = (uint32_t) (workload.hot_keys * workload.datasetsize);
+      if(hot < 1)
+        hot = 1;
+      if(hot >= (uint32_t) workload.datasetsize || workloadUniform(w) < workload.hot_ops)
+        return workloadRange(w, hot);
+      return hot + workloadRange(w, workload.datasetsize - hot);
+
+    case DIST_SEQUENTIAL:
+      // inserts crescentes por thread, lookups e removes uniformes
+      if(op == OP_INSERT){
+        key = w->next_key;
+        if(++w->next_key == (uint32_t) workload.datasetsize)
+          w->next_key = 0;
+        return key;
+      }
+      return workloadRange(w, workload.datasetsize);
+
+    default:
+      return workloadRange(w, workload.datasetsize);
+  }
+}
+
+/* Próxima operação da thread; a chave vai para *val */
+static inline int workloadNext(workload_t* w, int* val){
+  double action;
+  uint32_t r;
+  int op;
+
+  if(w->ops != NULL){
+    r = w->ops[w->pos];
+    if(++w->pos == w->n_ops)
+      w->pos = 0;
+    *val = TRACE_KEY(r);
+    return TRACE_OP(r);
+  }
+
+  action = workloadUniform(w);
+  if(action < workload.lookupPct)
+    op = OP_LOOKUP;
+  else if(action < workload.insertPct)
+    op = OP_INSERT;
+  else
+    op = OP_REMOVE;
+
+  *val = workloadKey(w, op);
+  return op;
+}
+#endif
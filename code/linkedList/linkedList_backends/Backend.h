@@ -0,0 +1,104 @@
+#ifndef BACKEND_H
+#define BACKEND_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRUE 1
+#define FALSE 0
+
+#define LOAD(addr) __atomic_load_n((addr), __ATOMIC_ACQUIRE)
+#define STORE(addr, v) __atomic_store_n((addr), (v), __ATOMIC_RELEASE)
+
+/* Versão da lista: o driver (LinkedList.c) só conversa com ela por aqui.
+   insert e remove devolvem TRUE se mudaram a lista, lookup se achou val */
+typedef struct list_backend_t{
+  const char* name;
+  const char* description;
+  size_t node_size;             // tamanho do nó, a média se ele for variável
+  int pool_ok;                  // nós de tamanho fixo, podem vir do pool (-p)
+  int needs_ebr;                // leitores sem lock: nós removidos passam pelo EBR
+  void (*init)(int n_threads);
+  void (*thread_init)(int tid); // pode ser NULL
+  int (*insert)(int val);
+  int (*lookup)(int val);
+  int (*remove)(int val);
+  int (*is_sane)();             // só é chamada sem threads rodando
+  void (*print)();
+
+  /* Lotes (--batch): vals vem ordenado e pode repetir chaves; aplica todos
+     numa travessia só e devolve quantos mudaram a lista (ou foram achados).
+     Podem ser NULL: o driver então chama a operação simples para cada um */
+  int (*insert_batch)(const int* vals, int n);
+  int (*lookup_batch)(const int* vals, int n);
+  int (*remove_batch)(const int* vals, int n);
+
+  void (*print_stats)();        // estatísticas próprias da versão, pode ser NULL
+
+  /* Chamada depois do join das threads, antes do sanity check: para o que
+     a versão deixou rodando. Pode ser NULL (e omitida no inicializador) */
+  void (*finish)();
+} list_backend_t;
+
+/* Alocação de nós fornecida pelo driver: malloc/free ou pool por thread (-p) */
+void* nodeAlloc(size_t size);
+
+void nodeFree(void* node);
+
+/* Libera um nó já desligado da lista; com EBR a liberação é adiada */
+void nodeRetire(void* node);
+
+/* Lista ordenada sem sincronização, usada pelas versões de lock global */
+typedef struct LLNode {
+    int val;
+    struct LLNode *next;
+} LLNode;
+
+LLNode* seqListInit();
+
+int seqListInsert(LLNode* sentinela, int val);
+
+int seqListLookup(LLNode* sentinela, int val);
+
+int seqListRemove(LLNode* sentinela, int val);
+
+int seqListIsSane(LLNode* sentinela);
+
+void seqListPrint(LLNode* sentinela);
+
+int seqListInsertBatch(LLNode* sentinela, const int* vals, int n);
+
+int seqListLookupBatch(LLNode* sentinela, const int* vals, int n);
+
+int seqListRemoveBatch(LLNode* sentinela, const int* vals, int n);
+
+extern list_backend_t backend_seq;
+extern list_backend_t backend_mutex;
+extern list_backend_t backend_spin;
+extern list_backend_t backend_sem;
+extern list_backend_t backend_rwlock;
+extern list_backend_t backend_brlock;
+extern list_backend_t backend_ticket;
+extern list_backend_t backend_mcs;
+extern list_backend_t backend_clh;
+extern list_backend_t backend_adaptive;
+extern list_backend_t backend_tm;
+extern list_backend_t backend_stm;
+extern list_backend_t backend_tbb;
+extern list_backend_t backend_handoverhand;
+extern list_backend_t backend_lazy;
+extern list_backend_t backend_lockfree;
+extern list_backend_t backend_skiplist;
+extern list_backend_t backend_unrolled;
+extern list_backend_t backend_cow;
+extern list_backend_t backend_fc;
+extern list_backend_t backend_delegate;
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,485 @@
+/* Versões com um lock global em volta da lista sequencial               */
+/* seq (sem lock), mutex, spin, sem, rwlock e brlock (big-reader lock)   */
+/* e os locks da QLock: ticket, mcs, clh e adaptive (spin, depois futex) */
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <sched.h>
+#include "Backend.h"
+#include "QLock.h"
+
+#ifndef CACHE_LINE
+#define CACHE_LINE 64
+#endif
+
+static LLNode* sentinela;
+
+static void coarseInit(int n_threads){
+  sentinela = seqListInit();
+}
+
+static int coarseIsSane(){
+  return seqListIsSane(sentinela);
+}
+
+static void coarsePrint(){
+  seqListPrint(sentinela);
+}
+
+/* seq: sem sincronização, só faz sentido com -n 1 */
+static int seqInsert(int val){
+  return seqListInsert(sentinela, val);
+}
+
+static int seqLookup(int val){
+  return seqListLookup(sentinela, val);
+}
+
+static int seqRemove(int val){
+  return seqListRemove(sentinela, val);
+}
+
+static int seqInsertBatch(const int* vals, int n){
+  return seqListInsertBatch(sentinela, vals, n);
+}
+
+static int seqLookupBatch(const int* vals, int n){
+  return seqListLookupBatch(sentinela, vals, n);
+}
+
+static int seqRemoveBatch(const int* vals, int n){
+  return seqListRemoveBatch(sentinela, vals, n);
+}
+
+list_backend_t backend_seq = {
+  "seq", "sem sincronização (só com uma thread)", sizeof(LLNode), TRUE, FALSE,
+  coarseInit, NULL, seqInsert, seqLookup, seqRemove, coarseIsSane, coarsePrint,
+  seqInsertBatch, seqLookupBatch, seqRemoveBatch
+};
+
+/* mutex */
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static int mutexInsert(int val){
+  pthread_mutex_lock(&mutex);
+  int done = seqListInsert(sentinela, val);
+  pthread_mutex_unlock(&mutex);
+  return done;
+}
+
+static int mutexLookup(int val){
+  pthread_mutex_lock(&mutex);
+  int found = seqListLookup(sentinela, val);
+  pthread_mutex_unlock(&mutex);
+  return found;
+}
+
+static int mutexRemove(int val){
+  pthread_mutex_lock(&mutex);
+  int done = seqListRemove(sentinela, val);
+  pthread_mutex_unlock(&mutex);
+  return done;
+}
+
+static int mutexInsertBatch(const int* vals, int n){
+  pthread_mutex_lock(&mutex);
+  int done = seqListInsertBatch(sentinela, vals, n);
+  pthread_mutex_unlock(&mutex);
+  return done;
+}
+
+static int mutexLookupBatch(const int* vals, int n){
+  pthread_mutex_lock(&mutex);
+  int found = seqListLookupBatch(sentinela, vals, n);
+  pthread_mutex_unlock(&mutex);
+  return found;
+}
+
+static int mutexRemoveBatch(const int* vals, int n){
+  pthread_mutex_lock(&mutex);
+  int done = seqListRemoveBatch(sentinela, vals, n);
+  pthread_mutex_unlock(&mutex);
+  return done;
+}
+
+list_backend_t backend_mutex = {
+  "mutex", "pthread_mutex global", sizeof(LLNode), TRUE, FALSE,
+  coarseInit, NULL, mutexInsert, mutexLookup, mutexRemove, coarseIsSane, coarsePrint,
+  mutexInsertBatch, mutexLookupBatch, mutexRemoveBatch
+};
+
+/* spin */
+static pthread_spinlock_t spin;
+
+static void spinInit(int n_threads){
+  pthread_spin_init(&spin, PTHREAD_PROCESS_PRIVATE);
+  coarseInit(n_threads);
+}
+
+static int spinInsert(int val){
+  pthread_spin_lock(&spin);
+  int done = seqListInsert(sentinela, val);
+  pthread_spin_unlock(&spin);
+  return done;
+}
+
+static int spinLookup(int val){
+  pthread_spin_lock(&spin);
+  int found = seqListLookup(sentinela, val);
+  pthread_spin_unlock(&spin);
+  return found;
+}
+
+static int spinRemove(int val){
+  pthread_spin_lock(&spin);
+  int done = seqListRemove(sentinela, val);
+  pthread_spin_unlock(&spin);
+  return done;
+}
+
+static int spinInsertBatch(const int* vals, int n){
+  pthread_spin_lock(&spin);
+  int done = seqListInsertBatch(sentinela, vals, n);
+  pthread_spin_unlock(&spin);
+  return done;
+}
+
+static int spinLookupBatch(const int* vals, int n){
+  pthread_spin_lock(&spin);
+  int found = seqListLookupBatch(sentinela, vals, n);
+  pthread_spin_unlock(&spin);
+  return found;
+}
+
+static int spinRemoveBatch(const int* vals, int n){
+  pthread_spin_lock(&spin);
+  int done = seqListRemoveBatch(sentinela, vals, n);
+  pthread_spin_unlock(&spin);
+  return done;
+}
+
+list_backend_t backend_spin = {
+  "spin", "pthread_spinlock global", sizeof(LLNode), TRUE, FALSE,
+  spinInit, NULL, spinInsert, spinLookup, spinRemove, coarseIsSane, coarsePrint,
+  spinInsertBatch, spinLookupBatch, spinRemoveBatch
+};
+
+/* sem */
+static sem_t sem;
+
+static void semInit(int n_threads){
+  sem_init(&sem, 0, 1);
+  coarseInit(n_threads);
+}
+
+static int semInsert(int val){
+  sem_wait(&sem);
+  int done = seqListInsert(sentinela, val);
+  sem_post(&sem);
+  return done;
+}
+
+static int semLookup(int val){
+  sem_wait(&sem);
+  int found = seqListLookup(sentinela, val);
+  sem_post(&sem);
+  return found;
+}
+
+static int semRemove(int val){
+  sem_wait(&sem);
+  int done = seqListRemove(sentinela, val);
+  sem_post(&sem);
+  return done;
+}
+
+static int semInsertBatch(const int* vals, int n){
+  sem_wait(&sem);
+  int done = seqListInsertBatch(sentinela, vals, n);
+  sem_post(&sem);
+  return done;
+}
+
+static int semLookupBatch(const int* vals, int n){
+  sem_wait(&sem);
+  int found = seqListLookupBatch(sentinela, vals, n);
+  sem_post(&sem);
+  return found;
+}
+
+static int semRemoveBatch(const int* vals, int n){
+  sem_wait(&sem);
+  int done = seqListRemoveBatch(sentinela, vals, n);
+  sem_post(&sem);
+  return done;
+}
+
+list_backend_t backend_sem = {
+  "sem", "semáforo POSIX global", sizeof(LLNode), TRUE, FALSE,
+  semInit, NULL, semInsert, semLookup, semRemove, coarseIsSane, coarsePrint,
+  semInsertBatch, semLookupBatch, semRemoveBatch
+};
+
+/* rwlock: lookups compartilham o lock */
+static pthread_rwlock_t rwlock = PTHREAD_RWLOCK_INITIALIZER;
+
+static int rwlockInsert(int val){
+  pthread_rwlock_wrlock(&rwlock);
+  int done = seqListInsert(sentinela, val);
+  pthread_rwlock_unlock(&rwlock);
+  return done;
+}
+
+static int rwlockLookup(int val){
+  pthread_rwlock_rdlock(&rwlock);
+  int found = seqListLookup(sentinela, val);
+  pthread_rwlock_unlock(&rwlock);
+  return found;
+}
+
+static int rwlockRemove(int val){
+  pthread_rwlock_wrlock(&rwlock);
+  int done = seqListRemove(sentinela, val);
+  pthread_rwlock_unlock(&rwlock);
+  return done;
+}
+
+static int rwlockInsertBatch(const int* vals, int n){
+  pthread_rwlock_wrlock(&rwlock);
+  int done = seqListInsertBatch(sentinela, vals, n);
+  pthread_rwlock_unlock(&rwlock);
+  return done;
+}
+
+static int rwlockLookupBatch(const int* vals, int n){
+  pthread_rwlock_rdlock(&rwlock);
+  int found = seqListLookupBatch(sentinela, vals, n);
+  pthread_rwlock_unlock(&rwlock);
+  return found;
+}
+
+static int rwlockRemoveBatch(const int* vals, int n){
+  pthread_rwlock_wrlock(&rwlock);
+  int done = seqListRemoveBatch(sentinela, vals, n);
+  pthread_rwlock_unlock(&rwlock);
+  return done;
+}
+
+list_backend_t backend_rwlock = {
+  "rwlock", "pthread_rwlock global, lookups compartilhados", sizeof(LLNode), TRUE, FALSE,
+  coarseInit, NULL, rwlockInsert, rwlockLookup, rwlockRemove, coarseIsSane, coarsePrint,
+  rwlockInsertBatch, rwlockLookupBatch, rwlockRemoveBatch
+};
+
+/* brlock: indicador de leitura por thread, cada um na sua linha de cache */
+typedef struct reader_t {
+  int active;
+  char pad[CACHE_LINE - sizeof(int)];
+} __attribute__((aligned(CACHE_LINE))) reader_t;
+
+/* Lock com viés para leitores: o leitor só escreve no seu próprio indicador,
+   o escritor levanta a flag writer e espera todos os indicadores zerarem */
+typedef struct brlock_t {
+  reader_t* readers;
+  int n_readers;
+  int writer;
+  pthread_mutex_t wlock;
+} brlock_t;
+
+static brlock_t brlock;
+static __thread int my_tid;
+
+static void brlockInit(int n_threads){
+  // um indicador extra para a thread principal (warm up)
+  brlock.n_readers = n_threads + 1;
+  brlock.readers = aligned_alloc(CACHE_LINE, sizeof(reader_t) * brlock.n_readers);
+  for(int i = 0; i < brlock.n_readers; i++)
+    brlock.readers[i].active = FALSE;
+  brlock.writer = FALSE;
+  pthread_mutex_init(&brlock.wlock, NULL);
+  my_tid = n_threads;
+  coarseInit(n_threads);
+}
+
+static void brlockThreadInit(int tid){
+  my_tid = tid;
+}
+
+static void brlockRead(){
+  reader_t* r = &brlock.readers[my_tid];
+
+  while(TRUE){
+    // announce the read, then check for a writer; the seq_cst store/load pair
+    // pairs with the writer raising its flag and then scanning the readers
+    __atomic_store_n(&r->active, TRUE, __ATOMIC_SEQ_CST);
+    if(!__atomic_load_n(&brlock.writer, __ATOMIC_SEQ_CST))
+      return;
+
+    // a writer is waiting or inside: step back so it can make progress
+    __atomic_store_n(&r->active, FALSE, __ATOMIC_RELEASE);
+    while(__atomic_load_n(&brlock.writer, __ATOMIC_ACQUIRE))
+      sched_yield();
+  }
+}
+
+static void brlockReadUnlock(){
+  __atomic_store_n(&brlock.readers[my_tid].active, FALSE, __ATOMIC_RELEASE);
+}
+
+static void brlockWrite(){
+  pthread_mutex_lock(&brlock.wlock);
+  __atomic_store_n(&brlock.writer, TRUE, __ATOMIC_SEQ_CST);
+
+  for(int i = 0; i < brlock.n_readers; i++)
+    while(__atomic_load_n(&brlock.readers[i].active, __ATOMIC_SEQ_CST))
+      sched_yield();
+}
+
+static void brlockWriteUnlock(){
+  __atomic_store_n(&brlock.writer, FALSE, __ATOMIC_RELEASE);
+  pthread_mutex_unlock(&brlock.wlock);
+}
+
+static int brlockInsert(int val){
+  brlockWrite();
+  int done = seqListInsert(sentinela, val);
+  brlockWriteUnlock();
+  return done;
+}
+
+static int brlockLookup(int val){
+  brlockRead();
+  int found = seqListLookup(sentinela, val);
+  brlockReadUnlock();
+  return found;
+}
+
+static int brlockRemove(int val){
+  brlockWrite();
+  int done = seqListRemove(sentinela, val);
+  brlockWriteUnlock();
+  return done;
+}
+
+static int brlockInsertBatch(const int* vals, int n){
+  brlockWrite();
+  int done = seqListInsertBatch(sentinela, vals, n);
+  brlockWriteUnlock();
+  return done;
+}
+
+static int brlockLookupBatch(const int* vals, int n){
+  brlockRead();
+  int found = seqListLookupBatch(sentinela, vals, n);
+  brlockReadUnlock();
+  return found;
+}
+
+static int brlockRemoveBatch(const int* vals, int n){
+  brlockWrite();
+  int done = seqListRemoveBatch(sentinela, vals, n);
+  brlockWriteUnlock();
+  return done;
+}
+
+list_backend_t backend_brlock = {
+  "brlock", "big-reader lock, indicador de leitura por thread", sizeof(LLNode), TRUE, FALSE,
+  brlockInit, brlockThreadInit, brlockInsert, brlockLookup, brlockRemove, coarseIsSane, coarsePrint,
+  brlockInsertBatch, brlockLookupBatch, brlockRemoveBatch
+};
+
+/* ticket, mcs, clh e adaptive: o mesmo código, muda só o tipo do lock */
+static qlock_t qlock;
+static int qlock_threads;
+
+static void qlockListInit(int n_threads, int kind){
+  qlockInit(&qlock, kind);
+  qlock_threads = n_threads;
+  coarseInit(n_threads);
+}
+
+static void ticketInit(int n_threads){
+  qlockListInit(n_threads, QLOCK_TICKET);
+}
+
+static void mcsInit(int n_threads){
+  qlockListInit(n_threads, QLOCK_MCS);
+}
+
+static void clhInit(int n_threads){
+  qlockListInit(n_threads, QLOCK_CLH);
+}
+
+static void adaptiveInit(int n_threads){
+  qlockListInit(n_threads, QLOCK_ADAPTIVE);
+}
+
+static int qlockInsert(int val){
+  qlockAcquire(&qlock);
+  int done = seqListInsert(sentinela, val);
+  qlockRelease(&qlock);
+  return done;
+}
+
+static int qlockLookup(int val){
+  qlockAcquire(&qlock);
+  int found = seqListLookup(sentinela, val);
+  qlockRelease(&qlock);
+  return found;
+}
+
+static int qlockRemove(int val){
+  qlockAcquire(&qlock);
+  int done = seqListRemove(sentinela, val);
+  qlockRelease(&qlock);
+  return done;
+}
+
+static int qlockInsertBatch(const int* vals, int n){
+  qlockAcquire(&qlock);
+  int done = seqListInsertBatch(sentinela, vals, n);
+  qlockRelease(&qlock);
+  return done;
+}
+
+static int qlockLookupBatch(const int* vals, int n){
+  qlockAcquire(&qlock);
+  int found = seqListLookupBatch(sentinela, vals, n);
+  qlockRelease(&qlock);
+  return found;
+}
+
+static int qlockRemoveBatch(const int* vals, int n){
+  qlockAcquire(&qlock);
+  int done = seqListRemoveBatch(sentinela, vals, n);
+  qlockRelease(&qlock);
+  return done;
+}
+
+static void qlockListPrintStats(){
+  qlockPrintStats(qlock_threads);
+}
+
+list_backend_t backend_ticket = {
+  "ticket", "ticket lock global, FIFO", sizeof(LLNode), TRUE, FALSE,
+  ticketInit, qlockThreadInit, qlockInsert, qlockLookup, qlockRemove, coarseIsSane, coarsePrint,
+  qlockInsertBatch, qlockLookupBatch, qlockRemoveBatch, qlockListPrintStats
+};
+
+list_backend_t backend_mcs = {
+  "mcs", "MCS lock global, cada thread espera no próprio nó", sizeof(LLNode), TRUE, FALSE,
+  mcsInit, qlockThreadInit, qlockInsert, qlockLookup, qlockRemove, coarseIsSane, coarsePrint,
+  qlockInsertBatch, qlockLookupBatch, qlockRemoveBatch, qlockListPrintStats
+};
+
+list_backend_t backend_clh = {
+  "clh", "CLH lock global, cada thread espera no nó do antecessor", sizeof(LLNode), TRUE, FALSE,
+  clhInit, qlockThreadInit, qlockInsert, qlockLookup, qlockRemove, coarseIsSane, coarsePrint,
+  qlockInsertBatch, qlockLookupBatch, qlockRemoveBatch, qlockListPrintStats
+};
+
+list_backend_t backend_adaptive = {
+  "adaptive", "lock global que gira pelo tempo médio de posse e depois dorme no futex", sizeof(LLNode), TRUE, FALSE,
+  adaptiveInit, qlockThreadInit, qlockInsert, qlockLookup, qlockRemove, coarseIsSane, coarsePrint,
+  qlockInsertBatch, qlockLookupBatch, qlockRemoveBatch, qlockListPrintStats
+};
@@ -0,0 +1,183 @@
+/* Versão cópia na escrita: o conjunto é um array ordenado imutável,      */
+/* publicado por um ponteiro atômico. Lookups fazem busca binária no      */
+/* snapshot corrente sem lock nem escrita compartilhada. Escritas são     */
+/* publicadas num slot por thread, como no flat combining, e quem pega o  */
+/* lock junta todas as pendentes num array novo e troca o ponteiro; o     */
+/* snapshot antigo é liberado pelo EBR depois que os leitores saem        */
+
+#include <string.h>
+#include "Backend.h"
+#include "Combining.h"
+#include "Workload.h"
+
+typedef struct snapshot_t{
+  int n;
+  int keys[];                   // estritamente crescentes
+} snapshot_t;
+
+static snapshot_t* current __attribute__((aligned(CACHE_LINE)));
+static combiner_t cow;
+static long copies = 0;
+
+static snapshot_t* newSnapshot(int capacity){
+  snapshot_t* s = malloc(sizeof(snapshot_t) + sizeof(int) * capacity);
+
+  s->n = 0;
+  return s;
+}
+
+// index of the first key >= val
+static inline int lowerBound(const snapshot_t* s, int val){
+  int lo = 0, hi = s->n;
+
+  while(lo < hi){
+    int mid = (lo + hi) >> 1;
+
+    if(s->keys[mid] < val)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  return lo;
+}
+
+static inline int contains(const snapshot_t* s, int val){
+  int i = lowerBound(s, val);
+
+  return i < s->n && s->keys[i] == val;
+}
+
+// merge every request with the current snapshot into a new array and
+// publish it; returns how many of the combiner's own batch keys took
+// effect. Requests for the same key are applied in the order they were
+// taken, so an insert followed by a remove leaves the key out. The slots
+// are answered after we return, so a writer that returns is always
+// followed by lookups that see its write
+static int cowPass(comb_request_t* requests, int k){
+  snapshot_t* old = current;
+  snapshot_t* novo;
+  int i, j, inserts = 0, changed = 0, done = 0;
+
+  for(i = 0; i < k; i++)
+    inserts += requests[i].op == OP_INSERT;
+  novo = newSnapshot(old->n + inserts);
+
+  // one merge pass over the old array
+  j = 0;
+  for(i = 0; i < k; ){
+    int val = requests[i].val;
+    int present;
+
+    while(j < old->n && old->keys[j] < val)
+      novo->keys[novo->n++] = old->keys[j++];
+    present = j < old->n && old->keys[j] == val;
+    if(present)
+      j++;
+
+    for(; i < k && requests[i].val == val; i++){
+      int result = FALSE;
+
+      if(requests[i].op == OP_INSERT && !present)
+        present = result = TRUE;
+      else if(requests[i].op == OP_REMOVE && present){
+        present = FALSE;
+        result = TRUE;
+      }
+      changed += result;
+
+      requests[i].result = result;
+      if(requests[i].slot < 0)
+        done += result;
+    }
+
+    if(present)
+      novo->keys[novo->n++] = val;
+  }
+  memcpy(&novo->keys[novo->n], &old->keys[j], sizeof(int) * (old->n - j));
+  novo->n += old->n - j;
+
+  // nothing changed: readers keep the old snapshot, no copy is published
+  if(changed > 0){
+    __atomic_store_n(&current, novo, __ATOMIC_RELEASE);
+    nodeRetire(old);
+    copies++;
+  } else {
+    free(novo);
+  }
+
+  return done;
+}
+
+static void cowInit(int n_threads){
+  combinerInit(&cow, n_threads, cowPass);
+  current = newSnapshot(0);
+}
+
+static void cowThreadInit(int tid){
+  combinerThreadInit(tid);
+}
+
+static int cowInsert(int val){
+  return combinerApply(&cow, OP_INSERT, val);
+}
+
+static int cowLookup(int val){
+  return contains(__atomic_load_n(&current, __ATOMIC_ACQUIRE), val);
+}
+
+static int cowRemove(int val){
+  return combinerApply(&cow, OP_REMOVE, val);
+}
+
+static int cowInsertBatch(const int* vals, int n){
+  return combinerApplyBatch(&cow, OP_INSERT, vals, n);
+}
+
+// the whole batch is answered from a single snapshot
+static int cowLookupBatch(const int* vals, int n){
+  snapshot_t* s = __atomic_load_n(&current, __ATOMIC_ACQUIRE);
+  int i, found = 0;
+
+  for(i = 0; i < n; i++)
+    found += contains(s, vals[i]);
+  return found;
+}
+
+static int cowRemoveBatch(const int* vals, int n){
+  return combinerApplyBatch(&cow, OP_REMOVE, vals, n);
+}
+
+static int cowIsSane(){
+  int i;
+
+  for(i = 1; i < current->n; i++){
+    if(current->keys[i - 1] >= current->keys[i]){
+      printf("FAILED SANITY CHECK IN: %d < %d\n", current->keys[i - 1], current->keys[i]);
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+static void cowPrint(){
+  int i;
+
+  printf("lista :");
+  for(i = 0; i < current->n; i++)
+    printf(" %d ->", current->keys[i]);
+  printf(" NULL\n\n");
+}
+
+static void cowPrintStats(){
+  printf("COW: %ld cópias publicadas, %.2f escritas por passe, %ld passes sem mudança\n",
+         copies, cow.passes > 0 ? (double) cow.combined / cow.passes : 0.0, cow.passes - copies);
+  printf("Snapshot final: %d chaves, %zu bytes\n", current->n,
+         sizeof(snapshot_t) + sizeof(int) * current->n);
+}
+
+list_backend_t backend_cow = {
+  "cow", "array ordenado com cópia na escrita: lookups por busca binária sem lock, escritas combinadas",
+  sizeof(snapshot_t), FALSE, TRUE,
+  cowInit, cowThreadInit, cowInsert, cowLookup, cowRemove, cowIsSane, cowPrint,
+  cowInsertBatch, cowLookupBatch, cowRemoveBatch, cowPrintStats
+};
@@ -0,0 +1,239 @@
+/* Versão delegação: uma thread servidora é dona da lista e é a única que */
+/* a toca. Cada cliente manda os pedidos por um anel SPSC próprio e       */
+/* espera a resposta no anel de volta, então a lista fica quente no cache */
+/* do servidor e não há lock nenhum. Mede a latência de ida e volta       */
+
+#include <string.h>
+#include <sched.h>
+#include <time.h>
+#include <pthread.h>
+#include "Backend.h"
+#include "Workload.h"
+#include "Placement.h"
+
+#ifndef CACHE_LINE
+#define CACHE_LINE 64
+#endif
+
+/* Potência de 2; com um pedido pendente por cliente basta pouco */
+#define DELEGATE_RING 8
+
+/* Voltas sem trabalho antes de ceder a CPU, no servidor e nos clientes */
+#define DELEGATE_SPINS 128
+
+/* Latências em baldes de potência de 2 (ns), até ~1 s */
+#define LAT_BUCKETS 32
+
+typedef struct delegate_msg_t{
+  int op;
+  int val;                      // na resposta, o resultado
+} delegate_msg_t;
+
+/* Anel de um produtor e um consumidor: cada índice na sua linha de cache,
+   só quem escreve nele o altera */
+typedef struct spsc_ring_t{
+  unsigned int tail __attribute__((aligned(CACHE_LINE)));  // produtor
+  unsigned int head __attribute__((aligned(CACHE_LINE)));  // consumidor
+  delegate_msg_t msgs[DELEGATE_RING] __attribute__((aligned(CACHE_LINE)));
+} spsc_ring_t;
+
+typedef struct delegate_client_t{
+  spsc_ring_t requests;         // cliente -> servidor
+  spsc_ring_t responses;        // servidor -> cliente
+
+  /* Só o cliente escreve; lidos depois do join */
+  long lat_hist[LAT_BUCKETS];
+  long lat_count;
+  double lat_sum;               // ns
+  long lat_max;                 // ns
+} __attribute__((aligned(CACHE_LINE))) delegate_client_t;
+
+static LLNode* sentinela;
+static delegate_client_t* clients;
+static int n_clients;
+static pthread_t server;
+static int stop = FALSE;        // o driver acabou, o servidor sai do laço
+static long served = 0;         // só o servidor escreve
+static long idle_rounds = 0;
+static __thread int my_client;
+
+static int ringPush(spsc_ring_t* r, delegate_msg_t m){
+  unsigned int tail = r->tail;
+
+  if(tail - LOAD(&r->head) == DELEGATE_RING)
+    return FALSE;
+  r->msgs[tail & (DELEGATE_RING - 1)] = m;
+  STORE(&r->tail, tail + 1);
+  return TRUE;
+}
+
+static int ringPop(spsc_ring_t* r, delegate_msg_t* m){
+  unsigned int head = r->head;
+
+  if(head == LOAD(&r->tail))
+    return FALSE;
+  *m = r->msgs[head & (DELEGATE_RING - 1)];
+  STORE(&r->head, head + 1);
+  return TRUE;
+}
+
+// the server owns the list: plain sequential operations, no synchronization
+static int serve(delegate_msg_t* m){
+  if(m->op == OP_LOOKUP)
+    return seqListLookup(sentinela, m->val);
+  if(m->op == OP_INSERT)
+    return seqListInsert(sentinela, m->val);
+  return seqListRemove(sentinela, m->val);
+}
+
+// polls every client ring round robin until delegateFinish; it is not
+// registered with the pool or EBR, so it allocates from the main
+// thread's pool and removed nodes are freed right away (no one else reads)
+static void* serverLoop(void* arg){
+  delegate_msg_t m;
+  int i, idle = 0, busy;
+
+  placementPin(n_clients - 1);
+  while(!LOAD(&stop)){
+    busy = FALSE;
+    for(i = 0; i < n_clients; i++){
+      while(ringPop(&clients[i].requests, &m)){
+        m.val = serve(&m);
+        served++;
+        // the client waits for each answer before the next request,
+        // so the response ring is never full
+        ringPush(&clients[i].responses, m);
+        busy = TRUE;
+      }
+    }
+
+    if(busy)
+      idle = 0;
+    else if(++idle == DELEGATE_SPINS){
+      idle = 0;
+      __atomic_fetch_add(&idle_rounds, 1, __ATOMIC_RELAXED);
+      sched_yield();
+    }
+  }
+  return NULL;
+}
+
+static void delegateInit(int n_threads){
+  // um cliente extra para a thread principal (warm up); o servidor fica
+  // com a posição n_threads na ordem de afinidade, depois dos clientes
+  n_clients = n_threads + 1;
+  clients = aligned_alloc(CACHE_LINE, sizeof(delegate_client_t) * n_clients);
+  memset(clients, 0, sizeof(delegate_client_t) * n_clients);
+  my_client = n_threads;
+  sentinela = seqListInit();
+
+  pthread_create(&server, NULL, serverLoop, NULL);
+}
+
+// every client has been joined and got all its answers, so no request is
+// left in the rings; the server stops before the sanity check and the stats
+static void delegateFinish(){
+  STORE(&stop, TRUE);
+  pthread_join(server, NULL);
+}
+
+static void delegateThreadInit(int tid){
+  my_client = tid;
+}
+
+static void recordLatency(delegate_client_t* c, struct timespec* start, struct timespec* end){
+  long ns = (end->tv_sec - start->tv_sec) * 1000000000L + (end->tv_nsec - start->tv_nsec);
+  int b = 0;
+
+  while((1L << (b + 1)) <= ns && b < LAT_BUCKETS - 1)
+    b++;
+  c->lat_hist[b]++;
+  c->lat_count++;
+  c->lat_sum += ns;
+  if(ns > c->lat_max)
+    c->lat_max = ns;
+}
+
+static int delegateApply(int op, int val){
+  delegate_client_t* c = &clients[my_client];
+  delegate_msg_t m = { op, val };
+  struct timespec start, end;
+  int spins = 0;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  while(!ringPush(&c->requests, m))
+    ;
+  while(!ringPop(&c->responses, &m)){
+    if(++spins == DELEGATE_SPINS){
+      spins = 0;
+      sched_yield();
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  recordLatency(c, &start, &end);
+  return m.val;
+}
+
+static int delegateInsert(int val){
+  return delegateApply(OP_INSERT, val);
+}
+
+static int delegateLookup(int val){
+  return delegateApply(OP_LOOKUP, val);
+}
+
+static int delegateRemove(int val){
+  return delegateApply(OP_REMOVE, val);
+}
+
+// only called after delegateFinish, the server is gone
+static int delegateIsSane(){
+  return seqListIsSane(sentinela);
+}
+
+static void delegatePrint(){
+  seqListPrint(sentinela);
+}
+
+/* Limite superior do balde onde cai a fração q das operações */
+static long percentile(long* hist, long count, double q){
+  long seen = 0;
+  int b;
+
+  for(b = 0; b < LAT_BUCKETS; b++){
+    seen += hist[b];
+    if(seen >= q * count)
+      return 1L << (b + 1);
+  }
+  return 1L << LAT_BUCKETS;
+}
+
+// a latência do warm up (cliente da thread principal) fica de fora
+static void delegatePrintStats(){
+  long hist[LAT_BUCKETS] = {0};
+  long count = 0, max = 0;
+  double sum = 0;
+  int i, b;
+
+  for(i = 0; i < n_clients - 1; i++){
+    for(b = 0; b < LAT_BUCKETS; b++)
+      hist[b] += clients[i].lat_hist[b];
+    count += clients[i].lat_count;
+    sum += clients[i].lat_sum;
+    if(clients[i].lat_max > max)
+      max = clients[i].lat_max;
+  }
+
+  printf("Delegação: %ld pedidos atendidos pelo servidor, %ld vezes ocioso\n",
+         served, __atomic_load_n(&idle_rounds, __ATOMIC_RELAXED));
+  if(count > 0)
+    printf("Latência ida e volta: média %.0lf ns, p50 < %ld ns, p99 < %ld ns, máxima %ld ns\n",
+           sum / count, percentile(hist, count, 0.50), percentile(hist, count, 0.99), max);
+}
+
+list_backend_t backend_delegate = {
+  "delegate", "delegação: uma thread servidora aplica os pedidos dos anéis SPSC", sizeof(LLNode), TRUE, FALSE,
+  delegateInit, delegateThreadInit, delegateInsert, delegateLookup, delegateRemove,
+  delegateIsSane, delegatePrint, NULL, NULL, NULL, delegatePrintStats, delegateFinish
+};
@@ -0,0 +1,97 @@
+/* Versão flat combining: cada thread publica a operação no seu slot e   */
+/* quem pega o lock vira o combinador, aplicando todos os pedidos        */
+/* pendentes numa varredura ordenada da lista. As outras threads só      */
+/* esperam no próprio slot, então o lock e a cabeça da lista não ficam   */
+/* pulando de cache em cache a cada operação                             */
+
+#include "Backend.h"
+#include "Combining.h"
+#include "Workload.h"
+
+static LLNode* sentinela;
+static combiner_t fc;
+
+// apply all requests in a single sweep; prev->next == curr and
+// prev->val < val hold between requests, so an insert followed by a lookup
+// of the same key sees it
+static int fcPass(comb_request_t* requests, int n){
+  LLNode* prev = sentinela;
+  LLNode* curr = sentinela->next;
+  int i;
+
+  for(i = 0; i < n; i++){
+    int val = requests[i].val;
+    int result = FALSE;
+
+    while (curr != NULL && curr->val < val){
+      prev = curr;
+      curr = prev->next;
+    }
+
+    if(requests[i].op == OP_LOOKUP)
+      result = ((curr != NULL) && (curr->val == val));
+    else if(requests[i].op == OP_INSERT){
+      if (!curr || (curr->val > val)){
+        // ESCRITA : REGIÃO CRITICA
+        LLNode* novo = nodeAlloc(sizeof(LLNode));
+        novo->val = val;
+        novo->next = curr;
+        prev->next = novo;
+        // FIM
+        curr = novo;
+        result = TRUE;
+      }
+    }
+    else if ((curr != NULL) && (curr->val == val)){
+      // ESCRITA : REGIÃO CRITICA
+      prev->next = curr->next;
+      nodeRetire(curr);
+      // FIM
+      curr = prev->next;
+      result = TRUE;
+    }
+
+    requests[i].result = result;
+  }
+  return 0;
+}
+
+static void fcInit(int n_threads){
+  combinerInit(&fc, n_threads, fcPass);
+  sentinela = seqListInit();
+}
+
+static void fcThreadInit(int tid){
+  combinerThreadInit(tid);
+}
+
+static int fcInsert(int val){
+  return combinerApply(&fc, OP_INSERT, val);
+}
+
+static int fcLookup(int val){
+  return combinerApply(&fc, OP_LOOKUP, val);
+}
+
+static int fcRemove(int val){
+  return combinerApply(&fc, OP_REMOVE, val);
+}
+
+static int fcIsSane(){
+  return seqListIsSane(sentinela);
+}
+
+static void fcPrint(){
+  seqListPrint(sentinela);
+}
+
+static void fcPrintStats(){
+  printf("FC: %ld passes de combinação, %.2f operações por passe\n",
+         fc.passes, fc.passes > 0 ? (double) fc.combined / fc.passes : 0.0);
+}
+
+list_backend_t backend_fc = {
+  "fc", "flat combining: um combinador aplica os pedidos publicados", sizeof(LLNode), TRUE, FALSE,
+  fcInit, fcThreadInit, fcInsert, fcLookup, fcRemove, fcIsSane, fcPrint,
+  NULL, NULL, NULL, fcPrintStats
+};
@@ -0,0 +1,146 @@
+/* Versão hand-over-hand: um mutex por nó, travados em pares */
+
+#include <pthread.h>
+#include "Backend.h"
+
+typedef struct HNode {
+    int val;
+    struct HNode *next;
+    pthread_mutex_t lock;
+} HNode;
+
+static HNode* sentinela;
+
+static void hohInit(int n_threads){
+  sentinela = malloc(sizeof(HNode));
+  sentinela->val = -1;
+  sentinela->next = NULL;
+  pthread_mutex_init(&sentinela->lock, NULL);
+}
+
+// traverse the list coupling the node locks: curr is only locked while prev
+// is still held, so no one can unlink or free a node we are about to visit.
+// On return prev and curr (if not NULL) are locked and curr is the first node
+// with curr->val >= val
+static void lockedSearch(int val, HNode** left, HNode** right){
+  HNode* prev = sentinela;
+  pthread_mutex_lock(&prev->lock);
+  HNode* curr = prev->next;
+  if (curr != NULL)
+    pthread_mutex_lock(&curr->lock);
+
+  while (curr != NULL){
+    if (curr->val >= val)
+      break;
+
+    pthread_mutex_unlock(&prev->lock);
+    prev = curr;
+    curr = prev->next;
+    if (curr != NULL)
+      pthread_mutex_lock(&curr->lock);
+  }
+
+  *left = prev;
+  *right = curr;
+}
+
+static void unlockSearch(HNode* prev, HNode* curr){
+  if (curr != NULL)
+    pthread_mutex_unlock(&curr->lock);
+  pthread_mutex_unlock(&prev->lock);
+}
+
+static int hohInsert(int val){
+  HNode *prev, *curr;
+  int done = FALSE;
+
+  // traverse the list to find the insertion point
+  lockedSearch(val, &prev, &curr);
+
+  // now insert new_node between prev and curr
+  if (!curr || (curr->val > val)){
+    // ESCRITA : REGIÃO CRITICA (prev e curr travados)
+    HNode* novo = nodeAlloc(sizeof(HNode));
+    novo->val = val;
+    novo->next = curr;
+    pthread_mutex_init(&novo->lock, NULL);
+
+    prev->next = novo;
+    done = TRUE;
+    // FIM
+  }
+  unlockSearch(prev, curr);
+  return done;
+}
+
+static int hohLookup(int val){
+  HNode *prev, *curr;
+  int found;
+
+  lockedSearch(val, &prev, &curr);
+  found = ((curr != NULL) && (curr->val == val));
+  unlockSearch(prev, curr);
+
+  return found;
+}
+
+static int hohRemove(int val){
+  HNode *prev, *curr;
+  int done = FALSE;
+
+  // find the node whose val matches the request
+  lockedSearch(val, &prev, &curr);
+
+  // if we find the node, disconnect it
+  if ((curr != NULL) && (curr->val == val)) {
+    // ESCRITA : REGIÃO CRITICA (prev e curr travados)
+    prev->next = curr->next;
+
+    // nobody else can be waiting on curr->lock: they would need prev first
+    pthread_mutex_unlock(&curr->lock);
+    pthread_mutex_destroy(&curr->lock);
+
+    nodeRetire(curr);
+    // FIM
+    curr = NULL;
+    done = TRUE;
+  }
+  unlockSearch(prev, curr);
+  return done;
+}
+
+/* Sanity Check */
+static int hohIsSane(){
+    int sane = TRUE;
+    HNode* prev = sentinela;
+    HNode* curr = prev->next;
+
+    while (curr != NULL) {
+        if ((prev->val) >= (curr->val)) {
+            printf("FAILED SANITY CHECK IN: %d < %d\n", prev->val, curr->val);
+            sane = FALSE;
+            break;
+        }
+        prev = curr;
+        curr = (curr->next);
+    }
+    return sane;
+}
+
+// print the list
+static void hohPrint(){
+    HNode* curr = sentinela->next;
+
+    printf("lista :");
+    while (curr != NULL){
+        printf(" %d ->", curr->val);
+        curr = (curr->next);
+    }
+
+    printf(" NULL\n\n");
+}
+
+list_backend_t backend_handoverhand = {
+  "handoverhand", "lock por nó com acoplamento (hand-over-hand)", sizeof(HNode), TRUE, FALSE,
+  hohInit, NULL, hohInsert, hohLookup, hohRemove, hohIsSane, hohPrint
+};
@@ -0,0 +1,171 @@
+/* Versão lazy: busca otimista sem locks, validação com prev e curr      */
+/* travados e remoção lógica por marca; lookups não travam nada          */
+
+#include <pthread.h>
+#include "Backend.h"
+
+typedef struct ZNode {
+    int val;
+    int marked;                 // TRUE quando o nó foi removido logicamente
+    struct ZNode *next;
+    pthread_mutex_t lock;
+} ZNode;
+
+static ZNode* sentinela;
+
+static void lazyInit(int n_threads){
+  sentinela = malloc(sizeof(ZNode));
+  sentinela->val = -1;
+  sentinela->marked = FALSE;
+  sentinela->next = NULL;
+  pthread_mutex_init(&sentinela->lock, NULL);
+}
+
+// optimistic traversal without locks; prev and curr are only trusted after
+// locking both and checking validate()
+static void search(int val, ZNode** left, ZNode** right){
+  ZNode* prev = sentinela;
+  ZNode* curr = LOAD(&prev->next);
+
+  while (curr != NULL){
+    if (curr->val >= val)
+      break;
+
+    prev = curr;
+    curr = LOAD(&prev->next);
+  }
+
+  *left = prev;
+  *right = curr;
+}
+
+static void lockPair(ZNode* prev, ZNode* curr){
+  pthread_mutex_lock(&prev->lock);
+  if (curr != NULL)
+    pthread_mutex_lock(&curr->lock);
+}
+
+static void unlockPair(ZNode* prev, ZNode* curr){
+  if (curr != NULL)
+    pthread_mutex_unlock(&curr->lock);
+  pthread_mutex_unlock(&prev->lock);
+}
+
+// with prev and curr locked: neither was removed and they are still adjacent
+static int validate(ZNode* prev, ZNode* curr){
+  return !prev->marked && (curr == NULL || !curr->marked) && (prev->next == curr);
+}
+
+static int lazyInsert(int val){
+  ZNode *prev, *curr;
+  int done = FALSE;
+
+  while (TRUE){
+    // traverse the list to find the insertion point
+    search(val, &prev, &curr);
+    lockPair(prev, curr);
+
+    if (!validate(prev, curr)){
+      unlockPair(prev, curr);
+      continue;
+    }
+
+    // now insert new_node between prev and curr
+    if (!curr || (curr->val > val)){
+      // ESCRITA : REGIÃO CRITICA (prev e curr travados)
+      ZNode* novo = nodeAlloc(sizeof(ZNode));
+      novo->val = val;
+      novo->marked = FALSE;
+      novo->next = curr;
+      pthread_mutex_init(&novo->lock, NULL);
+
+      STORE(&prev->next, novo);
+      done = TRUE;
+      // FIM
+    }
+    unlockPair(prev, curr);
+    return done;
+  }
+}
+
+// wait-free, takes no locks and never writes to the list
+static int lazyLookup(int val){
+  ZNode* curr = LOAD(&sentinela->next);
+
+  while (curr != NULL) {
+    if (curr->val >= val)
+      break;
+
+    curr = LOAD(&curr->next);
+  }
+
+  return ((curr != NULL) && (curr->val == val) && !LOAD(&curr->marked));
+}
+
+static int lazyRemove(int val){
+  ZNode *prev, *curr;
+
+  while (TRUE){
+    // find the node whose val matches the request
+    search(val, &prev, &curr);
+    lockPair(prev, curr);
+
+    if (!validate(prev, curr)){
+      unlockPair(prev, curr);
+      continue;
+    }
+
+    // if we find the node, disconnect it
+    if ((curr != NULL) && (curr->val == val)) {
+      // ESCRITA : REGIÃO CRITICA (prev e curr travados)
+
+      // logical deletion first, so lookups stop reporting it
+      STORE(&curr->marked, TRUE);
+      STORE(&prev->next, curr->next);
+      unlockPair(prev, curr);
+
+      // lock-free readers may still be on curr: free it later
+      nodeRetire(curr);
+      // FIM
+      return TRUE;
+    }
+    unlockPair(prev, curr);
+    return FALSE;
+  }
+}
+
+/* Sanity Check */
+static int lazyIsSane(){
+    int sane = TRUE;
+    ZNode* prev = sentinela;
+    ZNode* curr = prev->next;
+
+    while (curr != NULL) {
+        if ((prev->val) >= (curr->val) || curr->marked) {
+            printf("FAILED SANITY CHECK IN: %d < %d\n", prev->val, curr->val);
+            sane = FALSE;
+            break;
+        }
+        prev = curr;
+        curr = (curr->next);
+    }
+    return sane;
+}
+
+// print the list
+static void lazyPrint(){
+    ZNode* curr = sentinela->next;
+
+    printf("lista :");
+    while (curr != NULL){
+        printf(" %d ->", curr->val);
+        curr = (curr->next);
+    }
+
+    printf(" NULL\n\n");
+}
+
+list_backend_t backend_lazy = {
+  "lazy", "lazy list: lock por nó, lookups sem lock", sizeof(ZNode), TRUE, TRUE,
+  lazyInit, NULL, lazyInsert, lazyLookup, lazyRemove, lazyIsSane, lazyPrint
+};
@@ -0,0 +1,160 @@
+/* Versão lock-free de Harris-Michael: o bit menos significativo de next */
+/* marca o nó como removido logicamente e as atualizações usam CAS       */
+
+#include <stdint.h>
+#include "Backend.h"
+
+typedef struct FNode {
+    int val;
+    struct FNode *next;
+} FNode;
+
+/* Bit menos significativo de FNode::next marca o nó como removido logicamente */
+#define MARK 1UL
+#define isMarked(p) (((uintptr_t) (p)) & MARK)
+#define getMarked(p) ((FNode*) (((uintptr_t) (p)) | MARK))
+#define getUnmarked(p) ((FNode*) (((uintptr_t) (p)) & ~MARK))
+
+#define CAS(addr, expected, desired) \
+  __atomic_compare_exchange_n((addr), &(FNode*){(expected)}, (desired), FALSE, \
+                              __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+
+static FNode* sentinela;
+
+static void lockfreeInit(int n_threads){
+  sentinela = malloc(sizeof(FNode));
+  sentinela->val = -1;
+  sentinela->next = NULL;
+}
+
+// returns the first unmarked node with val >= val (or NULL) and stores its
+// unmarked predecessor in *left; marked nodes found on the way are physically
+// unlinked, restarting from sentinela whenever a CAS fails
+static FNode* search(int val, FNode** left){
+  FNode *prev, *curr, *succ;
+
+retry:
+  prev = sentinela;
+  curr = getUnmarked(LOAD(&prev->next));
+
+  while (curr != NULL){
+    succ = LOAD(&curr->next);
+
+    if (isMarked(succ)){
+      // curr was logically deleted; try to unlink it from prev
+      if (!CAS(&prev->next, curr, getUnmarked(succ)))
+        goto retry;
+
+      nodeRetire(curr);
+      curr = getUnmarked(succ);
+      continue;
+    }
+
+    if (curr->val >= val)
+      break;
+
+    prev = curr;
+    curr = succ;
+  }
+
+  *left = prev;
+  return curr;
+}
+
+static int lockfreeInsert(int val){
+  FNode *prev, *curr;
+  FNode* novo = nodeAlloc(sizeof(FNode));
+  novo->val = val;
+
+  while (TRUE){
+    curr = search(val, &prev);
+
+    if (curr && (curr->val == val)){
+      nodeFree(novo);
+      return FALSE;
+    }
+
+    // now link new_node between prev and curr; fails if prev was marked or
+    // another node was linked after it in the meantime
+    novo->next = curr;
+    if (CAS(&prev->next, curr, novo))
+      return TRUE;
+  }
+}
+
+// wait-free, never writes to the list
+static int lockfreeLookup(int val){
+  FNode* curr = getUnmarked(LOAD(&sentinela->next));
+
+  while (curr != NULL) {
+    if (curr->val >= val)
+      break;
+
+    curr = getUnmarked(LOAD(&curr->next));
+  }
+
+  return ((curr != NULL) && (curr->val == val) && !isMarked(LOAD(&curr->next)));
+}
+
+static int lockfreeRemove(int val){
+  FNode *prev, *curr, *succ;
+
+  while (TRUE){
+    curr = search(val, &prev);
+
+    // this means the search failed
+    if (!curr || (curr->val != val))
+      return FALSE;
+
+    // logical deletion: mark curr->next so no one links after curr anymore
+    succ = LOAD(&curr->next);
+    if (isMarked(succ))
+      continue;
+    if (!CAS(&curr->next, succ, getMarked(succ)))
+      continue;
+
+    // physical deletion; if it fails, search unlinks curr for us
+    if (CAS(&prev->next, curr, succ))
+      nodeRetire(curr);
+    else
+      search(val, &prev);
+
+    return TRUE;
+  }
+}
+
+/* Sanity Check */
+static int lockfreeIsSane(){
+    int sane = TRUE;
+    FNode* prev = sentinela;
+    FNode* curr = getUnmarked(prev->next);
+
+    while (curr != NULL) {
+        if ((prev->val) >= (curr->val) || isMarked(curr->next)) {
+            printf("FAILED SANITY CHECK IN: %d < %d\n", prev->val, curr->val);
+            sane = FALSE;
+            break;
+        }
+        prev = curr;
+        curr = getUnmarked(curr->next);
+    }
+    return sane;
+}
+
+// print the list
+static void lockfreePrint(){
+    FNode* curr = getUnmarked(sentinela->next);
+
+    printf("lista :");
+    while (curr != NULL){
+        printf(" %d ->", curr->val);
+        curr = getUnmarked(curr->next);
+    }
+
+    printf(" NULL\n\n");
+}
+
+list_backend_t backend_lockfree = {
+  "lockfree", "lock-free de Harris-Michael (CAS com marca no ponteiro)", sizeof(FNode), TRUE, TRUE,
+  lockfreeInit, NULL, lockfreeInsert, lockfreeLookup, lockfreeRemove, lockfreeIsSane, lockfreePrint
+};
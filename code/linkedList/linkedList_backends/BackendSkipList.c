@@ -0,0 +1,290 @@
+/* Versão skip list lazy (Herlihy et al.): locks nos predecessores só    */
+/* durante a escrita, lookups sem locks. Os nós têm tamanho variável,    */
+/* então vêm sempre do malloc e o pool (-p) não se aplica                */
+
+#include <time.h>
+#include <pthread.h>
+#include "Backend.h"
+
+/* 2^24 nós cabem com p = 1/2 por nível */
+#define MAX_LEVEL 24
+
+typedef struct SNode {
+    int val;
+    int topLevel;               // índice do nível mais alto em que o nó aparece
+    int marked;                 // TRUE quando o nó foi removido logicamente
+    int fullyLinked;            // TRUE quando o nó já está ligado em todos os níveis
+    pthread_mutex_t lock;
+    struct SNode *next[];       // topLevel + 1 ponteiros, next[0] é a lista completa
+} SNode;
+
+static SNode* sentinela;
+static __thread unsigned int level_seed = 2463534242u;
+
+/* Aloca um nó com topLevel + 1 níveis */
+static SNode* newNode(int val, int topLevel){
+  SNode* node = malloc(sizeof(SNode) + sizeof(SNode*) * (topLevel + 1));
+  node->val = val;
+  node->topLevel = topLevel;
+  node->marked = FALSE;
+  node->fullyLinked = FALSE;
+  pthread_mutex_init(&node->lock, NULL);
+  return node;
+}
+
+static void skiplistInit(int n_threads){
+  int i;
+
+  sentinela = newNode(-1, MAX_LEVEL - 1);
+  for (i = 0; i < MAX_LEVEL; i++)
+    sentinela->next[i] = NULL;
+  sentinela->fullyLinked = TRUE;
+}
+
+static void skiplistThreadInit(int tid){
+  level_seed = time(NULL) + tid + 1;
+}
+
+/* Nível aleatório com distribuição geométrica (p = 1/2), sem usar rand() */
+static int randomLevel(){
+  int level = 0;
+
+  // xorshift32 por thread
+  level_seed ^= level_seed << 13;
+  level_seed ^= level_seed >> 17;
+  level_seed ^= level_seed << 5;
+
+  unsigned int bits = level_seed;
+  while ((bits & 1) && level < MAX_LEVEL - 1){
+    level++;
+    bits >>= 1;
+  }
+  return level;
+}
+
+// optimistic traversal without locks; fills preds/succs for every level and
+// returns the highest level where a node with val was found, or -1
+static int search(int val, SNode** preds, SNode** succs){
+  int lFound = -1;
+  int level;
+  SNode* prev = sentinela;
+
+  for (level = MAX_LEVEL - 1; level >= 0; level--){
+    SNode* curr = LOAD(&prev->next[level]);
+
+    while (curr != NULL && curr->val < val){
+      prev = curr;
+      curr = LOAD(&prev->next[level]);
+    }
+
+    if (lFound == -1 && curr != NULL && curr->val == val)
+      lFound = level;
+
+    preds[level] = prev;
+    succs[level] = curr;
+  }
+
+  return lFound;
+}
+
+// unlock every distinct pred locked up to highestLocked; preds never increase
+// going up, so equal preds are always on consecutive levels
+static void unlockPreds(SNode** preds, int highestLocked){
+  int level;
+
+  for (level = 0; level <= highestLocked; level++){
+    if (level == 0 || preds[level] != preds[level - 1])
+      pthread_mutex_unlock(&preds[level]->lock);
+  }
+}
+
+static int skiplistInsert(int val){
+  SNode* preds[MAX_LEVEL];
+  SNode* succs[MAX_LEVEL];
+  int topLevel = randomLevel();
+  int level, lFound, highestLocked, valid;
+  SNode *prev, *succ, *prevPred;
+
+  while (TRUE){
+    // traverse the list to find the insertion point
+    lFound = search(val, preds, succs);
+
+    if (lFound != -1){
+      SNode* found = succs[lFound];
+
+      // already in the list: wait for a concurrent insert to finish linking
+      if (!LOAD(&found->marked)){
+        while (!LOAD(&found->fullyLinked))
+          ;
+        return FALSE;
+      }
+      // being removed: try again once it is unlinked
+      continue;
+    }
+
+    // lock and validate the preds from the bottom up
+    highestLocked = -1;
+    prevPred = NULL;
+    valid = TRUE;
+    for (level = 0; valid && level <= topLevel; level++){
+      prev = preds[level];
+      succ = succs[level];
+      if (prev != prevPred){
+        pthread_mutex_lock(&prev->lock);
+        highestLocked = level;
+        prevPred = prev;
+      }
+      valid = !LOAD(&prev->marked) && (succ == NULL || !LOAD(&succ->marked)) &&
+              prev->next[level] == succ;
+    }
+
+    if (!valid){
+      unlockPreds(preds, highestLocked);
+      continue;
+    }
+
+    // ESCRITA : REGIÃO CRITICA (preds travados)
+    SNode* novo = newNode(val, topLevel);
+    for (level = 0; level <= topLevel; level++)
+      novo->next[level] = succs[level];
+    for (level = 0; level <= topLevel; level++)
+      STORE(&preds[level]->next[level], novo);
+
+    // linearization point: lookups only report fully linked nodes
+    STORE(&novo->fullyLinked, TRUE);
+    // FIM
+
+    unlockPreds(preds, highestLocked);
+    return TRUE;
+  }
+}
+
+// wait-free, takes no locks and never writes to the list
+static int skiplistLookup(int val){
+  int level;
+  SNode* prev = sentinela;
+  SNode* curr = NULL;
+
+  for (level = MAX_LEVEL - 1; level >= 0; level--){
+    curr = LOAD(&prev->next[level]);
+
+    while (curr != NULL && curr->val < val){
+      prev = curr;
+      curr = LOAD(&prev->next[level]);
+    }
+
+    if (curr != NULL && curr->val == val)
+      break;
+  }
+
+  return ((curr != NULL) && (curr->val == val) &&
+          LOAD(&curr->fullyLinked) && !LOAD(&curr->marked));
+}
+
+static int skiplistRemove(int val){
+  SNode* preds[MAX_LEVEL];
+  SNode* succs[MAX_LEVEL];
+  SNode* victim = NULL;
+  int isMarked = FALSE;
+  int topLevel = -1;
+  int level, lFound, highestLocked, valid;
+  SNode *prev, *prevPred;
+
+  while (TRUE){
+    // find the node whose val matches the request
+    lFound = search(val, preds, succs);
+    if (lFound != -1)
+      victim = succs[lFound];
+
+    // only a fully linked node found at its top level can be removed; if it
+    // is already marked by someone else, the search failed
+    if (!isMarked && (lFound == -1 || !LOAD(&victim->fullyLinked) ||
+                      victim->topLevel != lFound || LOAD(&victim->marked)))
+      return FALSE;
+
+    if (!isMarked){
+      topLevel = victim->topLevel;
+      pthread_mutex_lock(&victim->lock);
+      if (victim->marked){
+        pthread_mutex_unlock(&victim->lock);
+        return FALSE;
+      }
+      // logical deletion first, so lookups stop reporting it
+      STORE(&victim->marked, TRUE);
+      isMarked = TRUE;
+    }
+
+    highestLocked = -1;
+    prevPred = NULL;
+    valid = TRUE;
+    for (level = 0; valid && level <= topLevel; level++){
+      prev = preds[level];
+      if (prev != prevPred){
+        pthread_mutex_lock(&prev->lock);
+        highestLocked = level;
+        prevPred = prev;
+      }
+      valid = !LOAD(&prev->marked) && prev->next[level] == victim;
+    }
+
+    if (!valid){
+      unlockPreds(preds, highestLocked);
+      continue;
+    }
+
+    // ESCRITA : REGIÃO CRITICA (preds e victim travados)
+    for (level = topLevel; level >= 0; level--)
+      STORE(&preds[level]->next[level], victim->next[level]);
+
+    pthread_mutex_unlock(&victim->lock);
+    unlockPreds(preds, highestLocked);
+
+    // lock-free readers may still be on victim: free it later
+    nodeRetire(victim);
+    // FIM
+    return TRUE;
+  }
+}
+
+/* Sanity Check */
+static int skiplistIsSane(){
+    int sane = TRUE;
+    int level;
+
+    for (level = 0; level < MAX_LEVEL && sane; level++){
+      SNode* prev = sentinela;
+      SNode* curr = prev->next[level];
+
+      while (curr != NULL) {
+          if ((prev->val) >= (curr->val) || curr->marked || curr->topLevel < level) {
+              printf("FAILED SANITY CHECK IN: %d < %d (nível %d)\n", prev->val, curr->val, level);
+              sane = FALSE;
+              break;
+          }
+          prev = curr;
+          curr = (curr->next[level]);
+      }
+    }
+    return sane;
+}
+
+// print the list
+static void skiplistPrint(){
+    SNode* curr = sentinela->next[0];
+
+    printf("lista :");
+    while (curr != NULL){
+        printf(" %d ->", curr->val);
+        curr = (curr->next[0]);
+    }
+
+    printf(" NULL\n\n");
+}
+
+// tamanho médio de um nó: com p = 1/2 são dois níveis em média
+list_backend_t backend_skiplist = {
+  "skiplist", "skip list lazy: locks nos predecessores, lookups sem lock",
+  sizeof(SNode) + 2 * sizeof(SNode*), FALSE, TRUE,
+  skiplistInit, skiplistThreadInit, skiplistInsert, skiplistLookup, skiplistRemove,
+  skiplistIsSane, skiplistPrint
+};
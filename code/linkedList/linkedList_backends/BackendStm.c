@@ -0,0 +1,211 @@
+/* Versão com a STM própria (TL2, common/STM.c) no lugar da libitm       */
+/* Mesmo código da versão tm, com as leituras e escritas de next         */
+/* instrumentadas; val não muda enquanto o nó está na lista. Uma         */
+/* transação condenada ainda pode ler um nó já removido antes de abortar */
+/* na validação, por isso os nós removidos passam sempre pelo EBR        */
+
+#include "Backend.h"
+#include "STM.h"
+
+static LLNode* sentinela;
+static int stm_threads;
+
+static void stmListInit(int n_threads){
+  stm_threads = n_threads;
+  sentinela = seqListInit();
+}
+
+static int stmInsert(int val){
+  LLNode* novo = nodeAlloc(sizeof(LLNode));
+  int used;
+
+  novo->val = val;
+  TM_BEGIN();
+    // traverse the list to find the insertion point
+    LLNode *prev = sentinela;
+    LLNode *curr = TM_READ(&sentinela->next);
+
+    used = FALSE;
+    while (curr != NULL) {
+      if (curr->val >= val)
+        break;
+
+      prev = curr;
+      curr = TM_READ(&prev->next);
+    }
+
+    // now insert new_node between prev and curr
+    if (!curr || (curr->val > val)) {
+      // ESCRITA : REGIÃO CRITICA
+      novo->next = curr;
+      TM_WRITE(&prev->next, novo);
+      used = TRUE;
+      // FIM
+    }
+  TM_END();
+
+  if (!used)
+    nodeFree(novo);
+  return used;
+}
+
+static int stmLookup(int val){
+  int found;
+
+  TM_BEGIN();
+    LLNode *curr = TM_READ(&sentinela->next);
+
+    while (curr != NULL) {
+      if (curr->val >= val)
+        break;
+
+      curr = TM_READ(&curr->next);
+    }
+
+    found = ((curr != NULL) && (curr->val == val));
+  TM_END();
+  return found;
+}
+
+static int stmRemove(int val){
+  LLNode *removed;
+
+  TM_BEGIN();
+    // find the node whose val matches the request
+    LLNode *prev = sentinela;
+    LLNode *curr = TM_READ(&prev->next);
+
+    removed = NULL;
+    while (curr != NULL) {
+      // if we find the node, disconnect it and end the search
+      if (curr->val == val) {
+        // ESCRITA : REGIÃO CRITICA
+        TM_WRITE(&prev->next, TM_READ(&curr->next));
+        removed = curr;
+        // FIM
+        break;
+      }
+      else if (curr->val > val) {
+        // this means the search failed
+        break;
+      }
+      prev = curr;
+      curr = TM_READ(&prev->next);
+    }
+  TM_END();
+
+  if (removed == NULL)
+    return FALSE;
+  nodeRetire(removed);
+  return TRUE;
+}
+
+/* Lotes: uma transação só para o lote inteiro, como na versão tm */
+static int stmInsertBatch(const int* vals, int n){
+  LLNode** novos = malloc(sizeof(LLNode*) * n);
+  int i, used;
+
+  for (i = 0; i < n; i++)
+    novos[i] = nodeAlloc(sizeof(LLNode));
+
+  TM_BEGIN();
+    LLNode *prev = sentinela;
+    LLNode *curr = TM_READ(&sentinela->next);
+
+    used = 0;
+    for (i = 0; i < n; i++){
+      if (i > 0 && vals[i] == vals[i - 1])
+        continue;
+
+      while (curr != NULL && curr->val < vals[i]){
+        prev = curr;
+        curr = TM_READ(&prev->next);
+      }
+
+      if (!curr || (curr->val > vals[i])){
+        // ESCRITA : REGIÃO CRITICA
+        LLNode* novo = novos[used++];
+        novo->val = vals[i];
+        novo->next = curr;
+        TM_WRITE(&prev->next, novo);
+        // FIM
+        prev = novo;
+      }
+    }
+  TM_END();
+
+  for (i = used; i < n; i++)
+    nodeFree(novos[i]);
+  free(novos);
+  return used;
+}
+
+static int stmLookupBatch(const int* vals, int n){
+  int i, found, last;
+
+  TM_BEGIN();
+    LLNode *curr = TM_READ(&sentinela->next);
+
+    found = 0;
+    last = FALSE;
+    for (i = 0; i < n; i++){
+      if (i == 0 || vals[i] != vals[i - 1]){
+        while (curr != NULL && curr->val < vals[i])
+          curr = TM_READ(&curr->next);
+
+        last = ((curr != NULL) && (curr->val == vals[i]));
+      }
+      found += last;
+    }
+  TM_END();
+  return found;
+}
+
+static int stmRemoveBatch(const int* vals, int n){
+  LLNode** removed = malloc(sizeof(LLNode*) * n);
+  int i, done;
+
+  TM_BEGIN();
+    LLNode *prev = sentinela;
+    LLNode *curr = TM_READ(&sentinela->next);
+
+    done = 0;
+    for (i = 0; i < n; i++){
+      while (curr != NULL && curr->val < vals[i]){
+        prev = curr;
+        curr = TM_READ(&prev->next);
+      }
+
+      if ((curr != NULL) && (curr->val == vals[i])){
+        // ESCRITA : REGIÃO CRITICA
+        TM_WRITE(&prev->next, TM_READ(&curr->next));
+        removed[done++] = curr;
+        // FIM
+        curr = TM_READ(&prev->next);
+      }
+    }
+  TM_END();
+
+  for (i = 0; i < done; i++)
+    nodeRetire(removed[i]);
+  free(removed);
+  return done;
+}
+
+static int stmIsSane(){
+  return seqListIsSane(sentinela);
+}
+
+static void stmPrint(){
+  seqListPrint(sentinela);
+}
+
+static void stmListPrintStats(){
+  stmPrintStats(stm_threads);
+}
+
+list_backend_t backend_stm = {
+  "stm", "STM própria no estilo TL2, com estatísticas de abort", sizeof(LLNode), TRUE, TRUE,
+  stmListInit, stmThreadInit, stmInsert, stmLookup, stmRemove, stmIsSane, stmPrint,
+  stmInsertBatch, stmLookupBatch, stmRemoveBatch, stmListPrintStats
+};
@@ -0,0 +1,56 @@
+/* Versão com o lock da TBB em volta da lista sequencial */
+/* Usa tbb::spin_mutex, com backoff e sem syscall        */
+
+#include "tbb/spin_mutex.h"
+#include "Backend.h"
+
+static LLNode* sentinela;
+static tbb::spin_mutex list_mutex;
+
+static void tbbInit(int n_threads){
+  sentinela = seqListInit();
+}
+
+static int tbbInsert(int val){
+  tbb::spin_mutex::scoped_lock lock(list_mutex);
+  return seqListInsert(sentinela, val);
+}
+
+static int tbbLookup(int val){
+  tbb::spin_mutex::scoped_lock lock(list_mutex);
+  return seqListLookup(sentinela, val);
+}
+
+static int tbbRemove(int val){
+  tbb::spin_mutex::scoped_lock lock(list_mutex);
+  return seqListRemove(sentinela, val);
+}
+
+static int tbbInsertBatch(const int* vals, int n){
+  tbb::spin_mutex::scoped_lock lock(list_mutex);
+  return seqListInsertBatch(sentinela, vals, n);
+}
+
+static int tbbLookupBatch(const int* vals, int n){
+  tbb::spin_mutex::scoped_lock lock(list_mutex);
+  return seqListLookupBatch(sentinela, vals, n);
+}
+
+static int tbbRemoveBatch(const int* vals, int n){
+  tbb::spin_mutex::scoped_lock lock(list_mutex);
+  return seqListRemoveBatch(sentinela, vals, n);
+}
+
+static int tbbIsSane(){
+  return seqListIsSane(sentinela);
+}
+
+static void tbbPrint(){
+  seqListPrint(sentinela);
+}
+
+list_backend_t backend_tbb = {
+  "tbb", "tbb::spin_mutex global", sizeof(LLNode), TRUE, FALSE,
+  tbbInit, NULL, tbbInsert, tbbLookup, tbbRemove, tbbIsSane, tbbPrint,
+  tbbInsertBatch, tbbLookupBatch, tbbRemoveBatch
+};
@@ -0,0 +1,198 @@
+/* Versão com memória transacional do GCC (-fgnu-tm)                     */
+/* O alocador do driver não é transaction_safe: o nó é alocado antes da  */
+/* transação e devolvido depois se não foi usado, e o nó removido só é   */
+/* liberado depois do commit                                             */
+
+#include "Backend.h"
+
+static LLNode* sentinela;
+
+static void tmInit(int n_threads){
+  sentinela = seqListInit();
+}
+
+static int tmInsert(int val){
+  LLNode* novo = nodeAlloc(sizeof(LLNode));
+  int used = FALSE;
+
+  __transaction_atomic{
+    // traverse the list to find the insertion point
+    LLNode *prev = sentinela;
+    LLNode *curr = sentinela->next;
+
+    while (curr != NULL) {
+      if (curr->val >= val)
+        break;
+
+      prev = curr;
+      curr = prev->next;
+    }
+
+    // now insert new_node between prev and curr
+    if (!curr || (curr->val > val)) {
+      // ESCRITA : REGIÃO CRITICA
+      novo->val = val;
+      novo->next = curr;
+      prev->next = novo;
+      used = TRUE;
+      // FIM
+    }
+  }
+
+  if (!used)
+    nodeFree(novo);
+  return used;
+}
+
+static int tmLookup(int val){
+  int found;
+
+  __transaction_atomic{
+    LLNode *curr = sentinela->next;
+
+    while (curr != NULL) {
+      if (curr->val >= val)
+        break;
+
+      curr = curr->next;
+    }
+
+    found = ((curr != NULL) && (curr->val == val));
+  }
+  return found;
+}
+
+static int tmRemove(int val){
+  LLNode *removed = NULL;
+
+  __transaction_atomic{
+    // find the node whose val matches the request
+    LLNode *prev = sentinela;
+    LLNode *curr = prev->next;
+
+    while (curr != NULL) {
+      // if we find the node, disconnect it and end the search
+      if (curr->val == val) {
+        // ESCRITA : REGIÃO CRITICA
+        prev->next = curr->next;
+        removed = curr;
+        // FIM
+        break;
+      }
+      else if (curr->val > val) {
+        // this means the search failed
+        break;
+      }
+      prev = curr;
+      curr = prev->next;
+    }
+  }
+
+  if (removed == NULL)
+    return FALSE;
+  nodeRetire(removed);
+  return TRUE;
+}
+
+/* Lotes: uma transação só para o lote inteiro; como nas operações
+   simples, os nós são alocados antes e os removidos aposentados depois */
+static int tmInsertBatch(const int* vals, int n){
+  LLNode** novos = malloc(sizeof(LLNode*) * n);
+  int i, used = 0;
+
+  for (i = 0; i < n; i++)
+    novos[i] = nodeAlloc(sizeof(LLNode));
+
+  __transaction_atomic{
+    LLNode *prev = sentinela;
+    LLNode *curr = sentinela->next;
+
+    for (i = 0; i < n; i++){
+      if (i > 0 && vals[i] == vals[i - 1])
+        continue;
+
+      while (curr != NULL && curr->val < vals[i]){
+        prev = curr;
+        curr = prev->next;
+      }
+
+      if (!curr || (curr->val > vals[i])){
+        // ESCRITA : REGIÃO CRITICA
+        LLNode* novo = novos[used++];
+        novo->val = vals[i];
+        novo->next = curr;
+        prev->next = novo;
+        // FIM
+        prev = novo;
+      }
+    }
+  }
+
+  for (i = used; i < n; i++)
+    nodeFree(novos[i]);
+  free(novos);
+  return used;
+}
+
+static int tmLookupBatch(const int* vals, int n){
+  int i, found = 0, last = FALSE;
+
+  __transaction_atomic{
+    LLNode *curr = sentinela->next;
+
+    for (i = 0; i < n; i++){
+      if (i == 0 || vals[i] != vals[i - 1]){
+        while (curr != NULL && curr->val < vals[i])
+          curr = curr->next;
+
+        last = ((curr != NULL) && (curr->val == vals[i]));
+      }
+      found += last;
+    }
+  }
+  return found;
+}
+
+static int tmRemoveBatch(const int* vals, int n){
+  LLNode** removed = malloc(sizeof(LLNode*) * n);
+  int i, done = 0;
+
+  __transaction_atomic{
+    LLNode *prev = sentinela;
+    LLNode *curr = sentinela->next;
+
+    for (i = 0; i < n; i++){
+      while (curr != NULL && curr->val < vals[i]){
+        prev = curr;
+        curr = prev->next;
+      }
+
+      if ((curr != NULL) && (curr->val == vals[i])){
+        // ESCRITA : REGIÃO CRITICA
+        prev->next = curr->next;
+        removed[done++] = curr;
+        // FIM
+        curr = prev->next;
+      }
+    }
+  }
+
+  for (i = 0; i < done; i++)
+    nodeRetire(removed[i]);
+  free(removed);
+  return done;
+}
+
+static int tmIsSane(){
+  return seqListIsSane(sentinela);
+}
+
+static void tmPrint(){
+  seqListPrint(sentinela);
+}
+
+list_backend_t backend_tm = {
+  "tm", "memória transacional do GCC (__transaction_atomic)", sizeof(LLNode), TRUE, FALSE,
+  tmInit, NULL, tmInsert, tmLookup, tmRemove, tmIsSane, tmPrint,
+  tmInsertBatch, tmLookupBatch, tmRemoveBatch
+};
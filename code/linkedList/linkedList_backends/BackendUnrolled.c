@@ -0,0 +1,294 @@
+/* Versão lista desenrolada: cada nó ocupa uma linha de cache e guarda até */
+/* UNROLLED_K chaves ordenadas, então uma travessia faz uma falta de cache */
+/* a cada K chaves em vez de uma por chave. A busca dentro do nó usa SSE2. */
+/* Nós dividem quando enchem e se juntam ao vizinho quando esvaziam. A     */
+/* sincronização é um pthread_rwlock global, como na versão rwlock         */
+
+#include <limits.h>
+#include <string.h>
+#include <pthread.h>
+#include "Backend.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#ifndef CACHE_LINE
+#define CACHE_LINE 64
+#endif
+
+/* 12 chaves, o contador e o next fecham 64 bytes */
+#define UNROLLED_K 12
+
+/* Abaixo disso o nó pega chaves do vizinho ou se junta a ele */
+#define UNROLLED_MIN (UNROLLED_K / 4)
+
+typedef struct UNode {
+    int keys[UNROLLED_K];       // ordenadas; as posições vazias têm INT_MAX
+    int count;
+    struct UNode *next;
+} __attribute__((aligned(CACHE_LINE))) UNode;
+
+/* Nós visitados pelos lookups, a medida de faltas de cache por busca; um
+   por thread, a thread principal (warm up) fica com o último */
+typedef struct unrolled_stats_t{
+  long lookups;
+  long visited;
+} __attribute__((aligned(CACHE_LINE))) unrolled_stats_t;
+
+static UNode* head;             // nunca sai da lista, pode ficar vazio
+static pthread_rwlock_t rwlock = PTHREAD_RWLOCK_INITIALIZER;
+static unrolled_stats_t* stats;
+static int n_stats;
+static __thread int my_stats;
+
+static UNode* initNode(UNode* node){
+  int i;
+
+  for (i = 0; i < UNROLLED_K; i++)
+    node->keys[i] = INT_MAX;
+  node->count = 0;
+  node->next = NULL;
+  return node;
+}
+
+static void unrolledInit(int n_threads){
+  n_stats = n_threads + 1;
+  stats = aligned_alloc(CACHE_LINE, sizeof(unrolled_stats_t) * n_stats);
+  memset(stats, 0, sizeof(unrolled_stats_t) * n_stats);
+  my_stats = n_threads;
+  // como as sentinelas das outras versões, vem antes do pool e nunca sai
+  head = initNode(aligned_alloc(CACHE_LINE, sizeof(UNode)));
+}
+
+static void unrolledThreadInit(int tid){
+  my_stats = tid;
+}
+
+// number of keys in the node smaller than val, i.e. where val is or would
+// go; the empty slots hold INT_MAX so they never count
+static inline int rank(UNode* node, int val){
+#ifdef __SSE2__
+  __m128i v = _mm_set1_epi32(val);
+  __m128i a = _mm_cmplt_epi32(_mm_loadu_si128((__m128i*) &node->keys[0]), v);
+  __m128i b = _mm_cmplt_epi32(_mm_loadu_si128((__m128i*) &node->keys[4]), v);
+  __m128i c = _mm_cmplt_epi32(_mm_loadu_si128((__m128i*) &node->keys[8]), v);
+
+  // each matching lane sets 4 bits of the byte mask
+  return __builtin_popcount(_mm_movemask_epi8(a)) / 4 + __builtin_popcount(_mm_movemask_epi8(b)) / 4
+       + __builtin_popcount(_mm_movemask_epi8(c)) / 4;
+#else
+  int i = 0;
+
+  while (i < node->count && node->keys[i] < val)
+    i++;
+  return i;
+#endif
+}
+
+// first node whose largest key is >= val (or the last node); the largest
+// key is in the same line as the rest of the node, so deciding to move on
+// costs no extra miss
+static UNode* findNode(int val, UNode** prev, long* visited){
+  UNode* p = NULL;
+  UNode* curr = head;
+
+  *visited = 1;
+  while (curr->next != NULL && (curr->count == 0 || curr->keys[curr->count - 1] < val)){
+    p = curr;
+    curr = curr->next;
+    (*visited)++;
+  }
+
+  if (prev)
+    *prev = p;
+  return curr;
+}
+
+static void insertAt(UNode* node, int pos, int val){
+  memmove(&node->keys[pos + 1], &node->keys[pos], sizeof(int) * (node->count - pos));
+  node->keys[pos] = val;
+  node->count++;
+}
+
+static void removeAt(UNode* node, int pos){
+  memmove(&node->keys[pos], &node->keys[pos + 1], sizeof(int) * (node->count - pos - 1));
+  node->count--;
+  node->keys[node->count] = INT_MAX;
+}
+
+// moves the upper half of a full node to a new node right after it
+static UNode* split(UNode* node){
+  UNode* upper = initNode(nodeAlloc(sizeof(UNode)));
+  int half = UNROLLED_K / 2, i;
+
+  memcpy(upper->keys, &node->keys[half], sizeof(int) * (UNROLLED_K - half));
+  upper->count = UNROLLED_K - half;
+  for (i = half; i < UNROLLED_K; i++)
+    node->keys[i] = INT_MAX;
+  node->count = half;
+
+  upper->next = node->next;
+  node->next = upper;
+  return upper;
+}
+
+// node fell below UNROLLED_MIN: absorb the next node if both fit in one,
+// otherwise borrow keys from it until they are balanced
+static void rebalance(UNode* node){
+  UNode* next = node->next;
+  int move, i;
+
+  if (next == NULL)
+    return;
+
+  if (node->count + next->count <= UNROLLED_K){
+    memcpy(&node->keys[node->count], next->keys, sizeof(int) * next->count);
+    node->count += next->count;
+    node->next = next->next;
+    nodeRetire(next);
+    return;
+  }
+
+  move = (next->count - node->count) / 2;
+  memcpy(&node->keys[node->count], next->keys, sizeof(int) * move);
+  node->count += move;
+  memmove(next->keys, &next->keys[move], sizeof(int) * (next->count - move));
+  for (i = next->count - move; i < next->count; i++)
+    next->keys[i] = INT_MAX;
+  next->count -= move;
+}
+
+static int unrolledInsert(int val){
+  UNode* node;
+  int pos, done = FALSE;
+  long visited;
+
+  pthread_rwlock_wrlock(&rwlock);
+  node = findNode(val, NULL, &visited);
+  pos = rank(node, val);
+
+  if (pos == node->count || node->keys[pos] != val){
+    if (node->count == UNROLLED_K){
+      UNode* upper = split(node);
+
+      if (pos > node->count){
+        pos -= node->count;
+        node = upper;
+      }
+    }
+    insertAt(node, pos, val);
+    done = TRUE;
+  }
+  pthread_rwlock_unlock(&rwlock);
+  return done;
+}
+
+static int unrolledLookup(int val){
+  UNode* node;
+  int pos, found;
+  long visited;
+
+  pthread_rwlock_rdlock(&rwlock);
+  node = findNode(val, NULL, &visited);
+  pos = rank(node, val);
+  found = pos < node->count && node->keys[pos] == val;
+  pthread_rwlock_unlock(&rwlock);
+
+  stats[my_stats].lookups++;
+  stats[my_stats].visited += visited;
+  return found;
+}
+
+static int unrolledRemove(int val){
+  UNode *node, *prev;
+  int pos, done = FALSE;
+  long visited;
+
+  pthread_rwlock_wrlock(&rwlock);
+  node = findNode(val, &prev, &visited);
+  pos = rank(node, val);
+
+  if (pos < node->count && node->keys[pos] == val){
+    removeAt(node, pos);
+    done = TRUE;
+
+    // an empty node other than head leaves the list; a small one merges
+    if (node->count == 0 && prev != NULL){
+      prev->next = node->next;
+      nodeRetire(node);
+    } else if (node->count < UNROLLED_MIN){
+      rebalance(node);
+    }
+  }
+  pthread_rwlock_unlock(&rwlock);
+  return done;
+}
+
+// only called with no threads running
+static int unrolledIsSane(){
+  UNode* node;
+  int last = -1, i;
+
+  for (node = head; node != NULL; node = node->next){
+    if (node->count == 0 && node != head){
+      printf("FAILED SANITY CHECK: empty node\n");
+      return FALSE;
+    }
+    for (i = 0; i < UNROLLED_K; i++){
+      if (i < node->count){
+        if (node->keys[i] <= last){
+          printf("FAILED SANITY CHECK IN: %d < %d\n", last, node->keys[i]);
+          return FALSE;
+        }
+        last = node->keys[i];
+      } else if (node->keys[i] != INT_MAX){
+        printf("FAILED SANITY CHECK: slot %d of a node with %d keys is not empty\n", i, node->count);
+        return FALSE;
+      }
+    }
+  }
+  return TRUE;
+}
+
+static void unrolledPrint(){
+  UNode* node;
+  int i;
+
+  printf("lista :");
+  for (node = head; node != NULL; node = node->next){
+    printf(" [");
+    for (i = 0; i < node->count; i++)
+      printf(" %d", node->keys[i]);
+    printf(" ] ->");
+  }
+  printf(" NULL\n\n");
+}
+
+// o warm up (contador da thread principal) fica de fora
+static void unrolledPrintStats(){
+  UNode* node;
+  long lookups = 0, visited = 0, nodes = 0, keys = 0;
+  int i;
+
+  for (i = 0; i < n_stats - 1; i++){
+    lookups += stats[i].lookups;
+    visited += stats[i].visited;
+  }
+  for (node = head; node != NULL; node = node->next){
+    nodes++;
+    keys += node->count;
+  }
+
+  printf("Lista desenrolada: %ld nós de %d bytes, %.1lf chaves por nó (máximo %d)\n",
+         nodes, (int) sizeof(UNode), (double) keys / nodes, UNROLLED_K);
+  if (lookups > 0)
+    printf("Nós (linhas de cache) visitados por lookup: %.1lf\n", (double) visited / lookups);
+}
+
+list_backend_t backend_unrolled = {
+  "unrolled", "lista desenrolada: 12 chaves por nó de 64 bytes, busca SSE2, pthread_rwlock global",
+  sizeof(UNode), TRUE, FALSE,
+  unrolledInit, unrolledThreadInit, unrolledInsert, unrolledLookup, unrolledRemove,
+  unrolledIsSane, unrolledPrint, NULL, NULL, NULL, unrolledPrintStats
+};
@@ -0,0 +1,140 @@
+/* Protocolo de combinação usado pelo flat combining e pela cópia na      */
+/* escrita: cada thread publica o pedido no seu slot e quem pega o lock   */
+/* vira o combinador, recolhe todos os pendentes e roda um passe da       */
+/* versão sobre eles. As outras threads só esperam no próprio slot        */
+
+#include <sched.h>
+#include "Backend.h"
+#include "Combining.h"
+
+/* Voltas esperando no slot antes de ceder a CPU */
+#define COMB_SPINS 128
+
+static __thread int my_slot;
+
+void combinerInit(combiner_t* c, int n_threads, comb_pass_t pass){
+  int i;
+
+  c->n_slots = n_threads + 1;
+  c->slots = aligned_alloc(CACHE_LINE, sizeof(comb_slot_t) * c->n_slots);
+  for(i = 0; i < c->n_slots; i++)
+    c->slots[i].pending = FALSE;
+  c->max_requests = c->n_slots;
+  c->requests = malloc(sizeof(comb_request_t) * c->max_requests);
+  c->pass = pass;
+  c->passes = 0;
+  c->combined = 0;
+  c->lock = FALSE;
+  my_slot = n_threads;
+}
+
+void combinerThreadInit(int tid){
+  my_slot = tid;
+}
+
+// requests in key order; equal keys keep the order they were taken
+static int compareRequests(const void* a, const void* b){
+  const comb_request_t* x = (const comb_request_t*) a;
+  const comb_request_t* y = (const comb_request_t*) b;
+
+  if(x->val != y->val)
+    return (x->val > y->val) - (x->val < y->val);
+  return x->order - y->order;
+}
+
+static inline int tryLock(combiner_t* c){
+  return !__atomic_load_n(&c->lock, __ATOMIC_RELAXED) &&
+         !__atomic_exchange_n(&c->lock, TRUE, __ATOMIC_ACQUIRE);
+}
+
+static inline void unlock(combiner_t* c){
+  __atomic_store_n(&c->lock, FALSE, __ATOMIC_RELEASE);
+}
+
+// with the lock held: take every published request plus the caller's own
+// batch (vals, n, op), run the backend's pass over them in key order and
+// only then answer the slots, so whatever the pass published is visible to
+// a thread that sees its answer
+static int combine(combiner_t* c, const int* vals, int n, int op){
+  comb_request_t* requests;
+  int i, k = 0, ret;
+
+  if(c->n_slots + n > c->max_requests){
+    c->max_requests = c->n_slots + n;
+    c->requests = realloc(c->requests, sizeof(comb_request_t) * c->max_requests);
+  }
+  requests = c->requests;
+
+  for(i = 0; i < c->n_slots; i++){
+    if(__atomic_load_n(&c->slots[i].pending, __ATOMIC_ACQUIRE)){
+      requests[k].val = c->slots[i].val;
+      requests[k].op = c->slots[i].op;
+      requests[k].slot = i;
+      requests[k].order = k;
+      k++;
+    }
+  }
+  for(i = 0; i < n; i++){
+    requests[k].val = vals[i];
+    requests[k].op = op;
+    requests[k].slot = -1;
+    requests[k].order = k;
+    k++;
+  }
+  qsort(requests, k, sizeof(comb_request_t), compareRequests);
+
+  ret = c->pass(requests, k);
+  c->passes++;
+  c->combined += k;
+
+  for(i = 0; i < k; i++){
+    if(requests[i].slot >= 0){
+      c->slots[requests[i].slot].result = requests[i].result;
+      __atomic_store_n(&c->slots[requests[i].slot].pending, FALSE, __ATOMIC_RELEASE);
+    }
+  }
+  return ret;
+}
+
+// our request is published before we try the lock, so the pass we run
+// always includes it
+int combinerApply(combiner_t* c, int op, int val){
+  comb_slot_t* s = &c->slots[my_slot];
+  int spins = 0;
+
+  s->op = op;
+  s->val = val;
+  __atomic_store_n(&s->pending, TRUE, __ATOMIC_RELEASE);
+
+  while(TRUE){
+    if(!__atomic_load_n(&s->pending, __ATOMIC_ACQUIRE))
+      return s->result;
+
+    if(tryLock(c)){
+      combine(c, NULL, 0, op);
+      unlock(c);
+      continue;
+    }
+
+    if(++spins == COMB_SPINS){
+      spins = 0;
+      sched_yield();
+    }
+  }
+}
+
+// the batch is applied by its own thread, together with whatever the other
+// threads published meanwhile
+int combinerApplyBatch(combiner_t* c, int op, const int* vals, int n){
+  int spins = 0, ret;
+
+  while(!tryLock(c)){
+    if(++spins == COMB_SPINS){
+      spins = 0;
+      sched_yield();
+    }
+  }
+  ret = combine(c, vals, n, op);
+  unlock(c);
+  return ret;
+}
@@ -0,0 +1,56 @@
+#ifndef COMBINING_H
+#define COMBINING_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef CACHE_LINE
+#define CACHE_LINE 64
+#endif
+
+/* Slot de publicação de uma thread, cada um na sua linha de cache */
+typedef struct comb_slot_t{
+  int pending;                  // TRUE do pedido até o combinador responder
+  int op;
+  int val;
+  int result;
+} __attribute__((aligned(CACHE_LINE))) comb_slot_t;
+
+/* Pedido copiado pelo combinador; slot -1 são as chaves de um lote do próprio combinador */
+typedef struct comb_request_t{
+  int val;
+  int op;
+  int slot;
+  int order;                    // ordem em que foi recolhido
+  int result;                   // preenchido pelo passe
+} comb_request_t;
+
+/* Um passe de combinação: recebe os pedidos ordenados por chave (chaves
+   iguais na ordem em que foram recolhidos), aplica todos e preenche
+   result de cada um. O que devolve é repassado a combinerApplyBatch */
+typedef int (*comb_pass_t)(comb_request_t* requests, int n);
+
+typedef struct combiner_t{
+  comb_slot_t* slots;
+  int n_slots;
+  comb_request_t* requests;     // só o combinador usa
+  int max_requests;
+  comb_pass_t pass;
+  long passes;
+  long combined;                // pedidos aplicados somando todos os passes
+  int lock __attribute__((aligned(CACHE_LINE)));
+} combiner_t;
+
+/* Um slot por thread e um extra para a thread principal (warm up) */
+void combinerInit(combiner_t* c, int n_threads, comb_pass_t pass);
+
+/* Associa a thread corrente ao slot tid */
+void combinerThreadInit(int tid);
+
+/* Publica o pedido e espera um combinador responder, ou vira o combinador */
+int combinerApply(combiner_t* c, int op, int val);
+
+/* Pega o lock e roda um passe com as chaves do lote junto dos pedidos
+   publicados; devolve o que o passe devolveu */
+int combinerApplyBatch(combiner_t* c, int op, const int* vals, int n);
+#endif
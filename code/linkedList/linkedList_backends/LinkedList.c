@@ -0,0 +1,626 @@
+/* Implementação do benchmark LinkedList da RSTM em C */
+/* Autor: Bruno Cesar, @bcesarg6, bcesar.g6@gmail.com */
+/* Abril de 2018                                      */
+/* Versão com a sincronização escolhida em tempo de   */
+/* execução (-m): um driver e uma estatística só      */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "Backend.h"
+#include "EBR.h"
+#include "NodePool.h"
+#include "Workload.h"
+#include "Timer.h"
+#include "Placement.h"
+
+/* Protege apenas as estatísticas, a lista é sincronizada pela versão escolhida */
+pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Versões disponíveis para -m, a primeira é a padrão */
+static list_backend_t* backends[] = {
+  &backend_mutex, &backend_seq, &backend_spin, &backend_sem, &backend_rwlock,
+  &backend_brlock, &backend_ticket, &backend_mcs, &backend_clh,
+  &backend_adaptive, &backend_tm, &backend_stm, &backend_tbb,
+  &backend_handoverhand, &backend_lazy, &backend_lockfree, &backend_skiplist,
+  &backend_unrolled, &backend_cow, &backend_fc, &backend_delegate, NULL
+};
+
+static list_backend_t* backend = NULL;
+static int lookups_true = 0;
+static int lookups_false = 0;
+static int inserts = 0;
+static int inserts_done = 0;
+static int removes = 0;
+static int removes_done = 0;
+
+/* Dados globais com valores padrão */
+static int datasetsize = 256;                  // number of items
+static double duration = 5.0f;                 // in seconds
+static int doWarmup = FALSE;
+static int usePool = FALSE;                    // aloca nós do pool por thread
+static int useEbr = FALSE;                     // libera nós removidos via EBR
+static int verbose = FALSE;
+static char* tracePath = NULL;                 // trace binário para replay (-r)
+static int sampleMs = 0;                       // intervalo da série de vazão (-I)
+static char* seriesPath = NULL;                // arquivo CSV da série (-o)
+static int num_ops = 0;                        // number of operations mode value.
+static int batchSize = 1;                      // operações por lote (-b)
+static int count_ops = 0;
+static int n_threads = 2;
+static float oversub = 0;                      // threads por CPU (-O), 0 usa -n
+static int n_cpus = 0;
+
+// these three are for getting various lookup/insert/remove ratios
+static float lookupPct = 0.34f;
+static float insertPct = 0.67f;
+static float insertFrac = -1.0f;               // -1: metade do que sobra dos lookups
+
+// Controla o tempo de execução
+struct timespec tstart, tend;
+double timeDiff;
+
+int gtid = 0;
+
+/* Exibe ajuda e finaliza o programa */
+void help(int msg){
+  int i;
+
+  switch (msg) {
+    case 1:
+      printf("\nNúmero insuficiente de parametros!\n");
+      break;
+
+    case 2:
+      printf("\nParametros de entrada inválidos!\n");
+      break;
+
+    default:
+      break;
+  }
+
+  printf("\n\tm : Versão da lista (sincronização) [mutex]");
+  printf("\n\tn : Número de threads [2]");
+  printf("\n\tO : Usa F threads por CPU online no lugar de -n, ex. 2 para o dobro [desativado]");
+	printf("\n\ts : Tamanho do datasetsize [256]");
+  printf("\n\tt : Tempo de duração da execução (segundos) [5.0]");
+  printf("\n\tw : Ativa o Warm Up antes da execução [FALSE]");
+  printf("\n\tp : Aloca os nós de um pool por thread em vez de malloc/free [FALSE]");
+  printf("\n\tx : Muda para o modo de execução por número de operações.");
+  printf("\n\tl : Fração de lookups [0.34]");
+  printf("\n\ti : Fração de inserts, o resto são removes [metade do que sobra dos lookups]");
+  printf("\n\tb : Agrupa K operações em lotes de chaves ordenadas, uma travessia por tipo [1]");
+  printf("\n\tk : Distribuição das chaves: uniform, zipf[:theta], hotspot[:chaves[:ops]] ou seq [uniform]");
+  printf("\n\te : Libera os nós removidos com EBR em vez de free imediato [FALSE]");
+  printf("\n\tr : Reproduz as operações de um trace gerado pelo tracegen");
+  printf("\n\tI : Amostra a vazão de cada thread a cada I ms [desativado]");
+  printf("\n\to : Grava a série de vazão em um arquivo CSV em vez da saída padrão");
+  printf("\n\ta : Afinidade: compact, scatter ou list:0,2,4-7 [nenhuma]");
+  printf("\n\tN : Política de memória NUMA: local ou interleave [padrão do sistema]");
+  printf("\n\tv : Ativa o modo verbose.");
+  printf("\n\th : Mostra essa mensagem\n");
+
+  printf("\nVersões (-m):");
+  for(i = 0; backends[i] != NULL; i++)
+    printf("\n\t%-13s %s%s", backends[i]->name, backends[i]->description,
+           backends[i]->needs_ebr ? " (sempre com EBR)" : "");
+  printf("\n\n");
+	exit(1);
+}
+
+/* Procura a versão pelo nome, aborta se não existir */
+list_backend_t* findBackend(const char* name){
+  int i;
+
+  for(i = 0; backends[i] != NULL; i++){
+    if(strcmp(backends[i]->name, name) == 0)
+      return backends[i];
+  }
+
+  printf("Versão da lista desconhecida: %s. Abortando...\n", name);
+  exit(1);
+}
+
+/* Pega argumentos com getopt */
+void getArgs(int argc, char *argv[]){
+	extern char *optarg;
+	char op;
+
+	struct option longopts[] = {
+    {"method", 1, NULL, 'm'},
+    {"n_threads", 1, NULL, 'n'},
+    {"oversubscribe", 1, NULL, 'O'},
+    {"size", 1, NULL, 's'},
+    {"time", 1, NULL, 't'},
+    {"warmup", 0, NULL, 'w'},
+    {"pool", 0, NULL, 'p'},
+    {"ebr", 0, NULL, 'e'},
+    {"verbose", 0, NULL, 'v'},
+    {"replay", 1, NULL, 'r'},
+    {"lookup", 1, NULL, 'l'},
+    {"insert", 1, NULL, 'i'},
+    {"keys", 1, NULL, 'k'},
+    {"batch", 1, NULL, 'b'},
+    {"interval", 1, NULL, 'I'},
+    {"series", 1, NULL, 'o'},
+    {"affinity", 1, NULL, 'a'},
+    {"numa", 1, NULL, 'N'},
+    {"x", 1, NULL, 'x'},
+    {NULL, 0, NULL, 0}
+	};
+
+	while ((op = getopt_long(argc, argv, "m:n:O:s:t:wpevx:l:i:k:b:r:I:o:a:N:h", longopts, NULL)) != -1) {
+		switch (op) {
+      case 'm':
+        backend = findBackend(optarg);
+        break;
+
+      case 'n':
+        n_threads = atoi(optarg);
+        break;
+
+      case 'O':
+        oversub = atof(optarg);
+        break;
+
+			case 's':
+				datasetsize = atoi(optarg);
+				break;
+
+      case 't':
+        duration = atof(optarg);
+        break;
+
+      case 'w':
+        doWarmup = TRUE;
+        break;
+
+      case 'p':
+        usePool = TRUE;
+        break;
+
+      case 'e':
+        useEbr = TRUE;
+        break;
+
+      case 'v':
+        verbose = TRUE;
+        break;
+
+      case 'x':
+        num_ops = atoi(optarg);
+        break;
+
+      case 'l':
+        lookupPct = atof(optarg);
+        break;
+
+      case 'i':
+        insertFrac = atof(optarg);
+        break;
+
+      case 'k':
+        workloadDist(optarg);
+        break;
+
+      case 'b':
+        batchSize = atoi(optarg);
+        break;
+
+      case 'I':
+        sampleMs = atoi(optarg);
+        break;
+
+      case 'o':
+        seriesPath = optarg;
+        break;
+
+      case 'a':
+        placementAffinity(optarg);
+        break;
+
+      case 'N':
+        placementNuma(optarg);
+        break;
+
+      case 'r':
+        tracePath = optarg;
+        break;
+
+      case 'h':
+        help(0);
+        break;
+
+			default:
+        help(2);
+        break;
+      }
+    }
+
+  if(backend == NULL)
+    backend = backends[0];
+
+  // mais threads que CPUs: mostra quem gira à toa e quem dorme cedo demais
+  if(oversub > 0){
+    n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    n_threads = (int) (oversub * n_cpus + 0.5f);
+  }
+
+  // versões com leitores sem lock não podem liberar um nó na hora
+  if(backend->needs_ebr)
+    useEbr = TRUE;
+
+  // a fração de removes é o que sobra
+  if(insertFrac < 0)
+    insertFrac = (1.0f - lookupPct) / 2;
+  insertPct = lookupPct + insertFrac;
+}
+
+/* Alocação dos nós, usada pelas versões: malloc/free ou pool por thread (-p) */
+void* nodeAlloc(size_t size){
+  if(usePool)
+    return poolAlloc();
+  return malloc(size);
+}
+
+void nodeFree(void* node){
+  if(usePool)
+    poolFree(node);
+  else
+    free(node);
+}
+
+void nodeRetire(void* node){
+  if(useEbr)
+    ebrRetire(node);
+  else
+    nodeFree(node);
+}
+
+/* Executa uma operação na versão escolhida, contando o resultado em stats:
+   lookups acertados, falhados, inserts, inserts efetivos, removes, removes efetivos */
+static inline void runOp(int tid, int op, int val, int* stats){
+  int result;
+
+  if(useEbr) ebrEnter();
+  if (op == OP_LOOKUP) {
+    result = backend->lookup(val);
+
+    if (result)
+      stats[0]++;
+    else
+      stats[1]++;
+
+    if(verbose) printf("%d -> lookup %d : %d\n", tid, val, result);
+  }
+  else if (op == OP_INSERT) {
+    if(verbose) printf("%d -> insert %d\n", tid, val);
+    stats[2]++;
+    stats[3] += backend->insert(val);
+  }
+  else {
+    if(verbose) printf("%d -> remove %d\n", tid, val);
+    stats[4]++;
+    stats[5] += backend->remove(val);
+  }
+  if(useEbr) ebrExit();
+}
+
+/* Lote de uma thread: as chaves separadas pelo tipo da operação */
+typedef struct batch_t{
+  int* keys[3];                 // indexado por OP_LOOKUP, OP_INSERT e OP_REMOVE
+  int n[3];
+} batch_t;
+
+static int compareKeys(const void* a, const void* b){
+  int x = *(const int*) a;
+  int y = *(const int*) b;
+
+  return (x > y) - (x < y);
+}
+
+/* Aplica n chaves ordenadas com a versão em lote, ou uma a uma se ela não tiver */
+static int applyBatch(int (*batch)(const int*, int), int (*single)(int), const int* vals, int n){
+  int i, done = 0;
+
+  if(batch != NULL)
+    return batch(vals, n);
+
+  for(i = 0; i < n; i++)
+    done += single(vals[i]);
+  return done;
+}
+
+/* Tira k operações do workload e aplica por tipo: lookups, inserts e removes,
+   cada grupo com as chaves ordenadas. A ordem dentro do lote se perde, o que
+   é o preço de percorrer a lista e pegar o lock uma vez por grupo */
+static void runBatch(int tid, workload_t* w, int k, batch_t* b, int* stats){
+  int i, op, val, done;
+
+  b->n[OP_LOOKUP] = b->n[OP_INSERT] = b->n[OP_REMOVE] = 0;
+  for(i = 0; i < k; i++){
+    op = workloadNext(w, &val);
+    b->keys[op][b->n[op]++] = val;
+  }
+
+  for(op = OP_LOOKUP; op <= OP_REMOVE; op++)
+    qsort(b->keys[op], b->n[op], sizeof(int), compareKeys);
+
+  if(useEbr) ebrEnter();
+  if(b->n[OP_LOOKUP] > 0){
+    done = applyBatch(backend->lookup_batch, backend->lookup, b->keys[OP_LOOKUP], b->n[OP_LOOKUP]);
+    stats[0] += done;
+    stats[1] += b->n[OP_LOOKUP] - done;
+  }
+  if(b->n[OP_INSERT] > 0){
+    done = applyBatch(backend->insert_batch, backend->insert, b->keys[OP_INSERT], b->n[OP_INSERT]);
+    stats[2] += b->n[OP_INSERT];
+    stats[3] += done;
+  }
+  if(b->n[OP_REMOVE] > 0){
+    done = applyBatch(backend->remove_batch, backend->remove, b->keys[OP_REMOVE], b->n[OP_REMOVE]);
+    stats[4] += b->n[OP_REMOVE];
+    stats[5] += done;
+  }
+  if(useEbr) ebrExit();
+
+  if(verbose) printf("%d -> lote: %d lookups, %d inserts, %d removes\n", tid,
+                     b->n[OP_LOOKUP], b->n[OP_INSERT], b->n[OP_REMOVE]);
+}
+
+/* Próximos k passos da thread: uma operação solta ou um lote */
+static inline void runStep(int tid, workload_t* w, int k, batch_t* b, int* stats){
+  int op, val;
+
+  if(k == 1){
+    op = workloadNext(w, &val);
+    runOp(tid, op, val, stats);
+  }
+  else
+    runBatch(tid, w, k, b, stats);
+}
+
+void* experiment(void* arg){
+  /* Garante thread id unico para a threads */
+  int tid = __atomic_fetch_add(&gtid, 1, __ATOMIC_RELAXED);
+  placementPin(tid);
+  if(usePool) poolRegister(tid);
+  if(useEbr) ebrRegister(tid);
+  if(backend->thread_init != NULL) backend->thread_init(tid);
+
+  //printf("tid = %d\n", tid);
+  int i, k;
+  workload_t w;
+  batch_t batch;
+  int l_ops = 0;
+  int stats[6] = {0, 0, 0, 0, 0, 0};
+
+  workloadThread(&w, tid);
+  for(i = 0; i < 3; i++)
+    batch.keys[i] = malloc(sizeof(int) * batchSize);
+
+  if(num_ops != 0){
+    for(i = 0; i < num_ops / n_threads; i += k){
+      // o último lote fica com o que sobrar
+      k = num_ops / n_threads - i;
+      if(k > batchSize)
+        k = batchSize;
+      runStep(tid, &w, k, &batch, stats);
+
+      l_ops += k;
+      timerCount(tid, l_ops);
+    }
+    // Time duration mode
+  } else {
+    while(timerRunning()){
+      runStep(tid, &w, batchSize, &batch, stats);
+
+      l_ops += batchSize;
+      timerCount(tid, l_ops);
+    }
+  }
+
+  for(i = 0; i < 3; i++)
+    free(batch.keys[i]);
+
+  pthread_mutex_lock(&mutex);
+  count_ops += l_ops;
+  lookups_true += stats[0];
+  lookups_false += stats[1];
+  inserts += stats[2];
+  inserts_done += stats[3];
+  removes += stats[4];
+  removes_done += stats[5];
+  pthread_mutex_unlock(&mutex);
+
+  return NULL;
+}
+
+/* Checa se os parametros são validos, aborta caso não sejam */
+void checkData(){
+  if(n_threads < 1){
+    printf("Número inválido de threads. Abortando...\n");
+    exit(1);
+  }
+
+  if(oversub < 0){
+    printf("Threads por CPU inválido. Abortando...\n");
+    exit(1);
+  }
+
+  if(backend == &backend_seq && n_threads > 1){
+    printf("A versão seq não tem sincronização, use -n 1. Abortando...\n");
+    exit(1);
+  }
+
+  if(usePool && !backend->pool_ok){
+    printf("A versão %s tem nós de tamanho variável e não usa o pool. Abortando...\n", backend->name);
+    exit(1);
+  }
+
+	if(datasetsize < 1){
+		printf("Tamanho da lista inválida. Abortando...\n");
+		exit(1);
+	}
+
+  if(duration <=0){
+    printf("Tempo de execução inválido. Abortando...\n");
+    exit(1);
+  }
+
+  if(num_ops < 0){
+    printf("Modo Número de operações: Valor inválido. Abortando...\n");
+    exit(1);
+  }
+
+  if(batchSize < 1){
+    printf("Tamanho de lote inválido. Abortando...\n");
+    exit(1);
+  }
+
+  if(lookupPct < 0 || lookupPct > 1){
+    printf("Fração de lookups inválida. Abortando...\n");
+    exit(1);
+  }
+
+  if(insertFrac < 0 || insertPct > 1.0001f){
+    printf("Fração de inserts inválida. Abortando...\n");
+    exit(1);
+  }
+
+  if(sampleMs < 0){
+    printf("Intervalo de amostragem inválido. Abortando...\n");
+    exit(1);
+  }
+
+  if(tracePath != NULL && n_threads > (int) workload.trace->n_threads){
+    printf("O trace só tem operações para %u threads. Abortando...\n", workload.trace->n_threads);
+    exit(1);
+  }
+}
+
+void printInfo(){
+  printf("\nVersão da lista = %s (%s)", backend->name, backend->description);
+  printf("\nNúmero de threads = %d", n_threads);
+  if(oversub > 0)
+    printf(" (%.2f por CPU, %d CPUs online)", oversub, n_cpus);
+  if(num_ops != 0)
+    printf("\nModo número de operações = %d operações", num_ops);
+  else
+    printf("\nModo tempo de execução = %.2lf segundos", duration);
+  printf("\nTamanho máximo da fila = %d nodes", datasetsize);
+  printf("\nPorcentagens das operações: %.2f Lookup / %.2f Insert / %.2f Remove",
+            lookupPct, insertPct - lookupPct, 1.0f - insertPct);
+  workloadPrintInfo();
+  placementPrintInfo(n_threads);
+
+  if(batchSize > 1){
+    printf("\nLotes de %d operações", batchSize);
+    if(backend->insert_batch != NULL)
+      printf(", uma travessia por tipo de operação");
+    else
+      printf(", sem versão em lote: uma operação por vez, com o EBR uma vez por lote");
+  }
+
+  if(doWarmup)
+    printf("\nWarm Up: ativado");
+  else
+    printf("\nWarm Up: desativado");
+
+  if(usePool)
+    printf("\nAlocação de nós: pool por thread");
+  else
+    printf("\nAlocação de nós: malloc/free");
+
+  if(useEbr)
+    printf("\nReclamação de memória: EBR");
+  else
+    printf("\nReclamação de memória: free imediato");
+}
+
+int main(int argc, char *argv[]) {
+  int i;
+  printf("\nLinked List - versão com sincronização selecionável\n");
+
+	getArgs(argc, argv);
+  placementInit();
+  workloadInit(tracePath, &datasetsize, &lookupPct, &insertPct);
+	checkData();
+  printInfo();
+
+  /* Inicializa a lista criando a sentinela */
+  backend->init(n_threads);
+
+  if(usePool) poolInit(n_threads, backend->node_size);
+  if(useEbr) ebrInit(n_threads, backend->node_size, nodeFree);
+
+  pthread_t threads[n_threads];
+  void* pth_status;
+
+  /* Warm Up */
+  // warmup inserts half of the elements in the datasetsize
+  if(doWarmup){
+    // as chaves já saem ordenadas: com a versão em lote é uma travessia só
+    int* keys = malloc(sizeof(int) * (datasetsize / 2 + 1));
+    int n = 0;
+
+    for (i = 0; i < datasetsize; i+=2)
+      keys[n++] = i;
+    applyBatch(backend->insert_batch, backend->insert, keys, n);
+    free(keys);
+  }
+
+  timerInit(n_threads, num_ops != 0 ? 0 : duration, sampleMs, seriesPath);
+  clock_gettime(CLOCK_MONOTONIC, &tstart);
+  timeDiff = 0;
+  timerStart();
+
+  printf("\n\n\t--- Rodando experimentos ---\n");
+  for(i = 0; i < n_threads; i++){
+		pthread_create(&threads[i], NULL, experiment, NULL);
+	}
+
+  for(i = 0; i < n_threads; i++){
+		 pthread_join(threads[i], &pth_status);
+	}
+
+  timerStop();
+  clock_gettime(CLOCK_MONOTONIC, &tend);
+  timeDiff = ((double)tend.tv_sec + 1.0e-9*tend.tv_nsec) - ((double)tstart.tv_sec + 1.0e-9*tstart.tv_nsec);
+  if(backend->finish != NULL) backend->finish();
+
+  printf("\t    FIM DA EXECUÇÃO.\n");
+
+  if(verbose) backend->print();
+  printf("\nSanity Check: ");
+  if(backend->is_sane())
+    printf("Passed\n");
+  else
+    printf("Failed! Isn't sane!\n");
+
+  printf("Tempo de execução dos experimentos = %lf segundos\n", timeDiff);
+  printf("Total de operações realizadas = %d\n",count_ops);
+  printf("Vazão = %.0lf operações por segundo\n", count_ops / timeDiff);
+  printf("Total de lookups acertados: %d\n", lookups_true);
+  printf("Total de lookups falhados: %d\n", lookups_false);
+  printf("Total de Inserts: %d (%d efetivos)\n", inserts, inserts_done);
+  printf("Total de removes: %d (%d efetivos)\n", removes, removes_done);
+  timerPrintSeries();
+  if(backend->print_stats != NULL) backend->print_stats();
+
+  if(useEbr){
+    ebrPrintStats();
+    ebrFlush();
+  }
+
+  if(usePool){
+    poolPrintStats();
+    poolDestroy();
+  }
+
+  return 0;
+}
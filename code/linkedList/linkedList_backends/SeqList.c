@@ -0,0 +1,200 @@
+/* Lista ordenada sem sincronização                                       */
+/* É o código das versões seq/mutex/spin/semaforo; aqui ele existe uma vez */
+/* só e cada versão de lock global apenas o envolve com o seu lock         */
+
+#include "Backend.h"
+
+/* Inicializa a lista criando a sentinela */
+LLNode* seqListInit(){
+  LLNode* sentinela = malloc(sizeof(LLNode));
+  sentinela->val = -1;
+  sentinela->next = NULL;
+  return sentinela;
+}
+
+// insert method; find the right place in the list, add val so that it is in
+// sorted order; if val is already in the list, exit without inserting
+int seqListInsert(LLNode* sentinela, int val){
+  // traverse the list to find the insertion point
+  LLNode* prev = sentinela;
+  LLNode* curr = sentinela->next;
+
+  while (curr != NULL){
+    if (curr->val >= val)
+      break;
+
+    prev = curr;
+    curr = prev->next;
+  }
+
+  // now insert new_node between prev and curr
+  if (!curr || (curr->val > val)){
+    // ESCRITA : REGIÃO CRITICA
+
+    LLNode* insert_point = prev;
+    LLNode* novo = nodeAlloc(sizeof(LLNode));
+    novo->val = val;
+    novo->next = curr;
+
+    insert_point->next = novo;
+    // FIM
+    return TRUE;
+  }
+  return FALSE;
+}
+
+// search function
+int seqListLookup(LLNode* sentinela, int val){
+  LLNode* curr = sentinela;
+  curr = curr->next;
+
+  while (curr != NULL) {
+    if (curr->val >= val)
+      break;
+
+    curr = curr->next;
+  }
+
+  return ((curr != NULL) && (curr->val == val));
+}
+
+// remove a node if its value == val
+int seqListRemove(LLNode* sentinela, int val){
+  // find the node whose val matches the request
+  LLNode* prev = sentinela;
+  LLNode* curr = prev->next;
+
+  while (curr != NULL) {
+    // if we find the node, disconnect it and end the search
+    if (curr->val == val) {
+      // ESCRITA : REGIÃO CRITICA
+
+      LLNode* mod_point = prev;
+      mod_point->next = curr->next;
+
+      // delete curr...
+      nodeRetire(curr);
+      // FIM
+      return TRUE;
+    }
+    else if (curr->val > val) {
+      // this means the search failed
+      break;
+    }
+    prev = curr;
+    curr = prev->next;
+  }
+  return FALSE;
+}
+
+/* Lotes: as chaves vêm ordenadas, então a posição de uma é o ponto de
+   partida da próxima e o lote inteiro custa uma travessia só */
+
+// insert every val not yet in the list; repeated keys only count once
+int seqListInsertBatch(LLNode* sentinela, const int* vals, int n){
+  LLNode* prev = sentinela;
+  LLNode* curr = sentinela->next;
+  int i, done = 0;
+
+  for (i = 0; i < n; i++){
+    int val = vals[i];
+
+    if (i > 0 && val == vals[i - 1])
+      continue;
+
+    while (curr != NULL && curr->val < val){
+      prev = curr;
+      curr = prev->next;
+    }
+
+    if (!curr || (curr->val > val)){
+      // ESCRITA : REGIÃO CRITICA
+      LLNode* novo = nodeAlloc(sizeof(LLNode));
+      novo->val = val;
+      novo->next = curr;
+
+      prev->next = novo;
+      // FIM
+      prev = novo;
+      done++;
+    }
+  }
+  return done;
+}
+
+// count how many vals are in the list; a repeated key repeats its result
+int seqListLookupBatch(LLNode* sentinela, const int* vals, int n){
+  LLNode* curr = sentinela->next;
+  int i, found = 0, last = FALSE;
+
+  for (i = 0; i < n; i++){
+    int val = vals[i];
+
+    if (i == 0 || val != vals[i - 1]){
+      while (curr != NULL && curr->val < val)
+        curr = curr->next;
+
+      last = ((curr != NULL) && (curr->val == val));
+    }
+    found += last;
+  }
+  return found;
+}
+
+// remove every val found; a repeated key finds it already gone
+int seqListRemoveBatch(LLNode* sentinela, const int* vals, int n){
+  LLNode* prev = sentinela;
+  LLNode* curr = sentinela->next;
+  int i, done = 0;
+
+  for (i = 0; i < n; i++){
+    int val = vals[i];
+
+    while (curr != NULL && curr->val < val){
+      prev = curr;
+      curr = prev->next;
+    }
+
+    if ((curr != NULL) && (curr->val == val)){
+      // ESCRITA : REGIÃO CRITICA
+      prev->next = curr->next;
+      nodeRetire(curr);
+      // FIM
+      curr = prev->next;
+      done++;
+    }
+  }
+  return done;
+}
+
+/* Sanity Check */
+int seqListIsSane(LLNode* sentinela){
+    int sane = TRUE;
+    LLNode* prev = sentinela;
+    LLNode* curr = prev->next;
+
+    while (curr != NULL) {
+        if ((prev->val) >= (curr->val)) {
+            printf("FAILED SANITY CHECK IN: %d < %d\n", prev->val, curr->val);
+            sane = FALSE;
+            break;
+        }
+        prev = curr;
+        curr = (curr->next);
+    }
+    return sane;
+}
+
+// print the list
+void seqListPrint(LLNode* sentinela){
+    LLNode* curr = sentinela;
+    curr = (curr->next);
+
+    printf("lista :");
+    while (curr != NULL){
+        printf(" %d ->", curr->val);
+        curr = (curr->next);
+    }
+
+    printf(" NULL\n\n");
+}
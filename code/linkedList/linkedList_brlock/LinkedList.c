@@ -0,0 +1,634 @@
+/* Implementação do benchmark LinkedList da RSTM em C */
+/* Autor: Bruno Cesar, @bcesarg6, bcesar.g6@gmail.com */
+/* Abril de 2018                                      */
+/* Versão big-reader lock (indicador por thread)      */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include "NodePool.h"
+#include "Workload.h"
+#include "Timer.h"
+#include "Placement.h"
+
+#define TRUE 1
+#define FALSE 0
+
+#define CACHE_LINE 64
+
+/* Protege apenas o id das threads e as estatísticas */
+pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Estruturas */
+typedef struct pthread_arg{
+  int in;
+  int out;
+}pthread_arg;
+
+typedef struct LLNode {
+    int val;
+    struct LLNode *next;
+} LLNode;
+
+/* Indicador de leitura de uma thread, cada um na sua linha de cache para que
+   leitores não disputem a mesma linha */
+typedef struct reader_t {
+  int active;
+  char pad[CACHE_LINE - sizeof(int)];
+} __attribute__((aligned(CACHE_LINE))) reader_t;
+
+/* Lock com viés para leitores: o leitor só escreve no seu próprio indicador,
+   o escritor levanta a flag writer e espera todos os indicadores zerarem */
+typedef struct brlock_t {
+  reader_t* readers;
+  int n_readers;
+  int writer;
+  pthread_mutex_t wlock;
+} brlock_t;
+
+brlock_t brlock;
+static __thread int my_tid;
+
+LLNode* sentinela;
+static int lookups_true = 0;
+static int lookups_false = 0;
+static int inserts = 0;
+static int removes = 0;
+
+/* Dados globais com valores padrão */
+static int datasetsize = 256;                  // number of items
+static double duration = 5.0f;                 // in seconds
+static int doWarmup = FALSE;
+static int usePool = FALSE;                    // aloca nós do pool por thread
+static int verbose = FALSE;
+static char* tracePath = NULL;                 // trace binário para replay (-r)
+static int sampleMs = 0;                       // intervalo da série de vazão (-I)
+static char* seriesPath = NULL;                // arquivo CSV da série (-o)
+static int num_ops = 0;                        // number of operations mode value.
+static int count_ops = 0;
+static int n_threads = 2;
+
+// these three are for getting various lookup/insert/remove ratios
+static float lookupPct = 0.34f;
+static float insertPct = 0.67f;
+static float insertFrac = -1.0f;               // -1: metade do que sobra dos lookups
+
+// Controla o tempo de execução
+struct timespec tstart, tend;
+double timeDiff;
+
+int gtid = 0;
+
+/* Exibe ajuda e finaliza o programa */
+void help(int msg){
+  switch (msg) {
+    case 1:
+      printf("\nNúmero insuficiente de parametros!\n");
+      break;
+
+    case 2:
+      printf("\nParametros de entrada inválidos!\n");
+      break;
+
+    default:
+      break;
+  }
+
+  printf("\n\tn : Número de threads [2]");
+	printf("\n\ts : Tamanho do datasetsize [256]");
+  printf("\n\tt : Tempo de duração da execução (segundos) [5.0]");
+  printf("\n\tw : Ativa o Warm Up antes da execução [FALSE]");
+  printf("\n\tp : Aloca os nós de um pool por thread em vez de malloc/free [FALSE]");
+  printf("\n\tx : Muda para o modo de execução por número de operações.");
+  printf("\n\tl : Fração de lookups [0.34]");
+  printf("\n\ti : Fração de inserts, o resto são removes [metade do que sobra dos lookups]");
+  printf("\n\tk : Distribuição das chaves: uniform, zipf[:theta], hotspot[:chaves[:ops]] ou seq [uniform]");
+  printf("\n\tr : Reproduz as operações de um trace gerado pelo tracegen");
+  printf("\n\tI : Amostra a vazão de cada thread a cada I ms [desativado]");
+  printf("\n\to : Grava a série de vazão em um arquivo CSV em vez da saída padrão");
+  printf("\n\ta : Afinidade: compact, scatter ou list:0,2,4-7 [nenhuma]");
+  printf("\n\tN : Política de memória NUMA: local ou interleave [padrão do sistema]");
+  printf("\n\tv : Ativa o modo verbose.");
+  printf("\n\th : Mostra essa mensagem\n\n");
+	exit(1);
+}
+
+/* Pega argumentos com getopt */
+void getArgs(int argc, char *argv[]){
+	extern char *optarg;
+	char op;
+
+	struct option longopts[] = {
+    {"n_threads", 1, NULL, 'n'},
+    {"size", 1, NULL, 's'},
+    {"time", 1, NULL, 't'},
+    {"warmup", 0, NULL, 'w'},
+    {"pool", 0, NULL, 'p'},
+    {"verbose", 0, NULL, 'v'},
+    {"replay", 1, NULL, 'r'},
+    {"insert", 1, NULL, 'i'},
+    {"keys", 1, NULL, 'k'},
+    {"interval", 1, NULL, 'I'},
+    {"series", 1, NULL, 'o'},
+    {"affinity", 1, NULL, 'a'},
+    {"numa", 1, NULL, 'N'},
+    {"x", 1, NULL, 'x'},
+    {"lookup", 1, NULL, 'l'}
+	};
+
+	while ((op = getopt_long(argc, argv, "n:s:t:wpvx:l:i:k:r:I:o:a:N:h", longopts, NULL)) != -1) {
+		switch (op) {
+      case 'n':
+        n_threads = atoi(optarg);
+        break;
+
+			case 's':
+				datasetsize = atoi(optarg);
+				break;
+
+      case 't':
+        duration = atof(optarg);
+        break;
+
+      case 'w':
+        doWarmup = TRUE;
+        break;
+
+      case 'p':
+        usePool = TRUE;
+        break;
+
+      case 'v':
+        verbose = TRUE;
+        break;
+
+      case 'x':
+        num_ops = atoi(optarg);
+        break;
+
+      case 'l':
+        lookupPct = atof(optarg);
+        break;
+
+      case 'i':
+        insertFrac = atof(optarg);
+        break;
+
+      case 'k':
+        workloadDist(optarg);
+        break;
+
+      case 'I':
+        sampleMs = atoi(optarg);
+        break;
+
+      case 'o':
+        seriesPath = optarg;
+        break;
+
+      case 'a':
+        placementAffinity(optarg);
+        break;
+
+      case 'N':
+        placementNuma(optarg);
+        break;
+
+      case 'r':
+        tracePath = optarg;
+        break;
+
+      case 'h':
+        help(0);
+        break;
+
+			default:
+        help(2);
+        break;
+      }
+    }
+
+  // a fração de removes é o que sobra
+  if(insertFrac < 0)
+    insertFrac = (1.0f - lookupPct) / 2;
+  insertPct = lookupPct + insertFrac;
+}
+
+void brlockInit(brlock_t* l, int n_readers){
+  l->readers = aligned_alloc(CACHE_LINE, sizeof(reader_t) * n_readers);
+  for(int i = 0; i < n_readers; i++)
+    l->readers[i].active = FALSE;
+  l->n_readers = n_readers;
+  l->writer = FALSE;
+  pthread_mutex_init(&l->wlock, NULL);
+}
+
+void brlockRead(brlock_t* l){
+  reader_t* r = &l->readers[my_tid];
+
+  while(TRUE){
+    // announce the read, then check for a writer; the seq_cst store/load pair
+    // pairs with the writer raising its flag and then scanning the readers
+    __atomic_store_n(&r->active, TRUE, __ATOMIC_SEQ_CST);
+    if(!__atomic_load_n(&l->writer, __ATOMIC_SEQ_CST))
+      return;
+
+    // a writer is waiting or inside: step back so it can make progress
+    __atomic_store_n(&r->active, FALSE, __ATOMIC_RELEASE);
+    while(__atomic_load_n(&l->writer, __ATOMIC_ACQUIRE))
+      sched_yield();
+  }
+}
+
+void brlockReadUnlock(brlock_t* l){
+  __atomic_store_n(&l->readers[my_tid].active, FALSE, __ATOMIC_RELEASE);
+}
+
+void brlockWrite(brlock_t* l){
+  pthread_mutex_lock(&l->wlock);
+  __atomic_store_n(&l->writer, TRUE, __ATOMIC_SEQ_CST);
+
+  for(int i = 0; i < l->n_readers; i++)
+    while(__atomic_load_n(&l->readers[i].active, __ATOMIC_SEQ_CST))
+      sched_yield();
+}
+
+void brlockWriteUnlock(brlock_t* l){
+  __atomic_store_n(&l->writer, FALSE, __ATOMIC_RELEASE);
+  pthread_mutex_unlock(&l->wlock);
+}
+
+/* Alocação dos nós: malloc/free ou pool por thread (-p) */
+LLNode* newNode(){
+  if(usePool)
+    return poolAlloc();
+  return malloc(sizeof(LLNode));
+}
+
+void freeNode(void* node){
+  if(usePool)
+    poolFree(node);
+  else
+    free(node);
+}
+
+/* Sanity Check */
+int isSane(){
+    int sane = TRUE;
+    brlockWrite(&brlock);
+    LLNode* prev = sentinela;
+    LLNode* curr = prev->next;
+
+    while (curr != NULL) {
+        if ((prev->val) >= (curr->val)) {
+            printf("FAILED SANITY CHECK IN: %d < %d\n", prev->val, curr->val);
+            sane = FALSE;
+            break;
+        }
+        prev = curr;
+        curr = (curr->next);
+    }
+    brlockWriteUnlock(&brlock);
+    return sane;
+}
+
+
+// insert method; find the right place in the list, add val so that it is in
+// sorted order; if val is already in the list, exit without inserting
+void insert(int val){
+  brlockWrite(&brlock);
+  // traverse the list to find the insertion point
+  LLNode* prev = sentinela;
+  LLNode* curr = sentinela->next;
+
+  while (curr != NULL){
+    if (curr->val >= val)
+      break;
+
+    prev = curr;
+    curr = prev->next;
+  }
+
+  // now insert new_node between prev and curr
+  if (!curr || (curr->val > val)){
+    // ESCRITA : REGIÃO CRITICA
+
+    LLNode* insert_point = prev;
+    LLNode* novo = newNode();
+    novo->val = val;
+    novo->next = curr;
+
+    insert_point->next = novo;
+    // FIM
+    }
+    brlockWriteUnlock(&brlock);
+}
+
+// search function
+void lookup(void* arg){
+  brlockRead(&brlock);
+  pthread_arg* p = (pthread_arg*) arg;
+  int val = p->in;
+
+  int found = FALSE;
+
+  LLNode* curr = sentinela;
+  curr = curr->next;
+
+  while (curr != NULL) {
+    if (curr->val >= val)
+      break;
+
+    curr = curr->next;
+  }
+
+  found = ((curr != NULL) && (curr->val == val));
+
+  p->out = found;
+  brlockReadUnlock(&brlock);
+}
+
+// remove a node if its value == val
+void removeNode(int val){
+  brlockWrite(&brlock);
+  // find the node whose val matches the request
+  LLNode* prev = sentinela;
+  LLNode* curr = prev->next;
+
+  while (curr != NULL) {
+    // if we find the node, disconnect it and end the search
+    if (curr->val == val) {
+      // ESCRITA : REGIÃO CRITICA
+
+      LLNode* mod_point = prev;
+      mod_point->next = curr->next;
+
+      // delete curr...
+      freeNode(curr);
+      // FIM
+      break;
+    }
+    else if (curr->val > val) {
+      // this means the search failed
+      break;
+    }
+    prev = curr;
+    curr = prev->next;
+  }
+  brlockWriteUnlock(&brlock);
+}
+
+// print the list
+void printLista(){
+    LLNode* curr = sentinela;
+    curr = (curr->next);
+
+    printf("lista :");
+    while (curr != NULL){
+        printf(" %d ->", curr->val);
+        curr = (curr->next);
+    }
+
+    printf(" NULL\n\n");
+}
+
+void* experiment(void* arg){
+  /* Garante thread id unico para a threads */
+  pthread_mutex_lock(&mutex);
+  int tid = gtid++;
+  pthread_mutex_unlock(&mutex);
+  placementPin(tid);
+  if(usePool) poolRegister(tid);
+  my_tid = tid;
+
+  //printf("tid = %d\n", tid);
+  int result, val, i;
+  int op;
+  workload_t w;
+  int l_ops, l_lookups_true, l_lookups_false, l_inserts, l_removes;
+  l_ops = l_lookups_true = l_lookups_false = l_inserts = l_removes = 0;
+
+  pthread_arg* p;
+  p = malloc(sizeof(pthread_arg));
+
+  workloadThread(&w, tid);
+
+  //printf("\nAction = %f | val = %d\n", action, val);
+
+  if(num_ops != 0){
+    for(i = 0; i < num_ops / n_threads; i++){
+      op = workloadNext(&w, &val);
+
+      if (op == OP_LOOKUP) {
+        p->in = val;
+        lookup(p);
+        result = p->out;
+
+        if (result)
+          l_lookups_true++;
+        else
+          l_lookups_false++;
+
+        if(verbose) printf("%d -> lookup %d : %d\n", tid, val, result);
+      }
+      else if (op == OP_INSERT) {
+        if(verbose) printf("%d -> insert %d\n", tid, val);
+        insert(val);
+        l_inserts++;
+      }
+      else {
+        if(verbose) printf("%d -> remove %d\n", tid, val);
+        removeNode(val);
+        l_removes++;
+      }
+
+      //int sane = isSane();
+      l_ops++;
+      timerCount(tid, l_ops);
+    }
+    // Time duration mode
+  } else {
+    //printf("%d Entrou time duration mode\n",tid);
+    while(timerRunning()){
+      op = workloadNext(&w, &val);
+      if (op == OP_LOOKUP) {
+        p->in = val;
+        lookup(p);
+        result = p->out;
+
+        if (result)
+          l_lookups_true++;
+        else
+          l_lookups_false++;
+
+        if(verbose) printf("%d -> lookup %d : %d\n", tid, val, result);
+      }
+      else if (op == OP_INSERT) {
+        if(verbose) printf("%d -> insert %d\n", tid, val);
+        insert(val);
+        l_inserts++;
+      }
+      else {
+        if(verbose) printf("%d -> remove %d\n", tid, val);
+        removeNode(val);
+        l_removes++;
+      }
+
+      //int sane = isSane();
+      l_ops++;
+      timerCount(tid, l_ops);
+    }
+  }
+
+  pthread_mutex_lock(&mutex);
+  count_ops += l_ops;
+  inserts += l_inserts;
+  lookups_true += l_lookups_true;
+  lookups_false += l_lookups_false;
+  removes += l_removes;
+  pthread_mutex_unlock(&mutex);
+}
+
+/* Checa se os parametros são validos, aborta caso não sejam */
+void checkData(){
+  if(n_threads < 1){
+    printf("Número inválido de threads. Abortando...\n");
+    exit(1);
+  }
+
+	if(datasetsize < 1){
+		printf("Tamanho da lista inválida. Abortando...\n");
+		exit(1);
+	}
+
+  if(duration <=0){
+    printf("Tempo de execução inválido. Abortando...\n");
+    exit(1);
+  }
+
+  if(num_ops < 0){
+    printf("Modo Número de operações: Valor inválido. Abortando...\n");
+    exit(1);
+  }
+
+  if(tracePath != NULL && n_threads > (int) workload.trace->n_threads){
+    printf("O trace só tem operações para %u threads. Abortando...\n", workload.trace->n_threads);
+    exit(1);
+  }
+
+  if(lookupPct < 0 || lookupPct > 1){
+    printf("Fração de lookups inválida. Abortando...\n");
+    exit(1);
+  }
+
+  if(insertFrac < 0 || insertPct > 1.0001f){
+    printf("Fração de inserts inválida. Abortando...\n");
+    exit(1);
+  }
+
+  if(sampleMs < 0){
+    printf("Intervalo de amostragem inválido. Abortando...\n");
+    exit(1);
+  }
+}
+
+void printInfo(){
+  printf("\nNúmero de threads = %d", n_threads);
+  if(num_ops != 0)
+    printf("\nModo número de operações = %d operações", num_ops);
+  else
+    printf("\nModo tempo de execução = %.2lf segundos", duration);
+  printf("\nTamanho máximo da fila = %d nodes", datasetsize);
+  printf("\nPorcentagens das operações: %.2f Lookup / %.2f Insert / %.2f Remove",
+            lookupPct, insertPct - lookupPct, 1.0f - insertPct);
+  workloadPrintInfo();
+  placementPrintInfo(n_threads);
+
+  if(doWarmup)
+    printf("\nWarm Up: ativado");
+  else
+    printf("\nWarm Up: desativado");
+
+  if(usePool)
+    printf("\nAlocação de nós: pool por thread");
+  else
+    printf("\nAlocação de nós: malloc/free");
+}
+
+int main(int argc, char *argv[]) {
+  int i;
+  printf("\nLinked List - versão big-reader lock\n");
+
+	getArgs(argc, argv);
+  placementInit();
+  workloadInit(tracePath, &datasetsize, &lookupPct, &insertPct);
+	checkData();
+  printInfo();
+
+  /* Inicializa a lista criando a sentinela */
+  sentinela = malloc(sizeof(LLNode));
+  sentinela->val = -1;
+  sentinela->next = NULL;
+
+  brlockInit(&brlock, n_threads);
+
+  if(usePool) poolInit(n_threads, sizeof(LLNode));
+
+  pthread_t threads[n_threads];
+  void* pth_status;
+
+  /* Warm Up */
+  // warmup inserts half of the elements in the datasetsize
+  if(doWarmup){
+      for (i = 0; i < datasetsize; i+=2) {
+        insert(i);
+      }
+  }
+
+  timerInit(n_threads, num_ops != 0 ? 0 : duration, sampleMs, seriesPath);
+  clock_gettime(CLOCK_MONOTONIC, &tstart);
+  timeDiff = 0;
+  timerStart();
+
+  printf("\n\n\t--- Rodando experimentos ---\n");
+  for(i = 0; i < n_threads; i++){
+		pthread_create(&threads[i], NULL, experiment, NULL);
+	}
+
+  //experiment(NULL);
+
+  for(i = 0; i < n_threads; i++){
+		 pthread_join(threads[i], &pth_status);
+	}
+
+  timerStop();
+  clock_gettime(CLOCK_MONOTONIC, &tend);
+  timeDiff = ((double)tend.tv_sec + 1.0e-9*tend.tv_nsec) - ((double)tstart.tv_sec + 1.0e-9*tstart.tv_nsec);
+
+  printf("\t    FIM DA EXECUÇÃO.\n");
+
+  if(verbose) printLista();
+  printf("\nSanity Check: ");
+  if(isSane())
+    printf("Passed\n");
+  else
+    printf("Failed! Isn't sane!\n");
+
+  printf("Tempo de execução dos experimentos = %lf segundos\n", timeDiff);
+  printf("Total de operações realizadas = %d\n",count_ops);
+  printf("Total de lookups acertados: %d\n", lookups_true);
+  printf("Total de lookups falhados: %d\n", lookups_false);
+  printf("Total de Inserts: %d\n", inserts);
+  printf("Total de removes: %d\n", removes);
+  timerPrintSeries();
+
+  if(usePool){
+    poolPrintStats();
+    poolDestroy();
+  }
+
+  return 0;
+}
@@ -0,0 +1,622 @@
+/* Implementação do benchmark LinkedList da RSTM em C */
+/* Autor: Bruno Cesar, @bcesarg6, bcesar.g6@gmail.com */
+/* Abril de 2018                                      */
+/* Versão lazy list (lookup sem locks)                */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+#include <time.h>
+#include <pthread.h>
+#include "EBR.h"
+#include "NodePool.h"
+#include "Workload.h"
+#include "Timer.h"
+#include "Placement.h"
+
+#define TRUE 1
+#define FALSE 0
+
+#define LOAD(addr) __atomic_load_n((addr), __ATOMIC_ACQUIRE)
+#define STORE(addr, v) __atomic_store_n((addr), (v), __ATOMIC_RELEASE)
+
+/* Protege apenas o id das threads e as estatísticas, a lista usa os locks dos nós */
+pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Estruturas */
+typedef struct pthread_arg{
+  int in;
+  int out;
+}pthread_arg;
+
+typedef struct LLNode {
+    int val;
+    int marked;                 // TRUE quando o nó foi removido logicamente
+    struct LLNode *next;
+    pthread_mutex_t lock;
+} LLNode;
+
+LLNode* sentinela;
+static int lookups_true = 0;
+static int lookups_false = 0;
+static int inserts = 0;
+static int removes = 0;
+
+/* Dados globais com valores padrão */
+static int datasetsize = 256;                  // number of items
+static double duration = 5.0f;                 // in seconds
+static int doWarmup = FALSE;
+static int usePool = FALSE;                    // aloca nós do pool por thread
+static int verbose = FALSE;
+static char* tracePath = NULL;                 // trace binário para replay (-r)
+static int sampleMs = 0;                       // intervalo da série de vazão (-I)
+static char* seriesPath = NULL;                // arquivo CSV da série (-o)
+static int num_ops = 0;                        // number of operations mode value.
+static int count_ops = 0;
+static int n_threads = 2;
+
+// these three are for getting various lookup/insert/remove ratios
+static float lookupPct = 0.34f;
+static float insertPct = 0.67f;
+static float insertFrac = -1.0f;               // -1: metade do que sobra dos lookups
+
+// Controla o tempo de execução
+struct timespec tstart, tend;
+double timeDiff;
+
+int gtid = 0;
+
+/* Exibe ajuda e finaliza o programa */
+void help(int msg){
+  switch (msg) {
+    case 1:
+      printf("\nNúmero insuficiente de parametros!\n");
+      break;
+
+    case 2:
+      printf("\nParametros de entrada inválidos!\n");
+      break;
+
+    default:
+      break;
+  }
+
+  printf("\n\tn : Número de threads [2]");
+	printf("\n\ts : Tamanho do datasetsize [256]");
+  printf("\n\tt : Tempo de duração da execução (segundos) [5.0]");
+  printf("\n\tw : Ativa o Warm Up antes da execução [FALSE]");
+  printf("\n\tp : Aloca os nós de um pool por thread em vez de malloc/free [FALSE]");
+  printf("\n\tx : Muda para o modo de execução por número de operações.");
+  printf("\n\tl : Fração de lookups [0.34]");
+  printf("\n\ti : Fração de inserts, o resto são removes [metade do que sobra dos lookups]");
+  printf("\n\tk : Distribuição das chaves: uniform, zipf[:theta], hotspot[:chaves[:ops]] ou seq [uniform]");
+  printf("\n\tr : Reproduz as operações de um trace gerado pelo tracegen");
+  printf("\n\tI : Amostra a vazão de cada thread a cada I ms [desativado]");
+  printf("\n\to : Grava a série de vazão em um arquivo CSV em vez da saída padrão");
+  printf("\n\ta : Afinidade: compact, scatter ou list:0,2,4-7 [nenhuma]");
+  printf("\n\tN : Política de memória NUMA: local ou interleave [padrão do sistema]");
+  printf("\n\tv : Ativa o modo verbose.");
+  printf("\n\th : Mostra essa mensagem\n\n");
+	exit(1);
+}
+
+/* Pega argumentos com getopt */
+void getArgs(int argc, char *argv[]){
+	extern char *optarg;
+	char op;
+
+	struct option longopts[] = {
+    {"n_threads", 1, NULL, 'n'},
+    {"size", 1, NULL, 's'},
+    {"time", 1, NULL, 't'},
+    {"warmup", 0, NULL, 'w'},
+    {"pool", 0, NULL, 'p'},
+    {"verbose", 0, NULL, 'v'},
+    {"replay", 1, NULL, 'r'},
+    {"lookup", 1, NULL, 'l'},
+    {"insert", 1, NULL, 'i'},
+    {"keys", 1, NULL, 'k'},
+    {"interval", 1, NULL, 'I'},
+    {"series", 1, NULL, 'o'},
+    {"affinity", 1, NULL, 'a'},
+    {"numa", 1, NULL, 'N'},
+    {"x", 1, NULL, 'x'}
+	};
+
+	while ((op = getopt_long(argc, argv, "n:s:t:wpvx:l:i:k:r:I:o:a:N:h", longopts, NULL)) != -1) {
+		switch (op) {
+      case 'n':
+        n_threads = atoi(optarg);
+        break;
+
+			case 's':
+				datasetsize = atoi(optarg);
+				break;
+
+      case 't':
+        duration = atof(optarg);
+        break;
+
+      case 'w':
+        doWarmup = TRUE;
+        break;
+
+      case 'p':
+        usePool = TRUE;
+        break;
+
+      case 'v':
+        verbose = TRUE;
+        break;
+
+      case 'x':
+        num_ops = atoi(optarg);
+        break;
+
+      case 'l':
+        lookupPct = atof(optarg);
+        break;
+
+      case 'i':
+        insertFrac = atof(optarg);
+        break;
+
+      case 'k':
+        workloadDist(optarg);
+        break;
+
+      case 'I':
+        sampleMs = atoi(optarg);
+        break;
+
+      case 'o':
+        seriesPath = optarg;
+        break;
+
+      case 'a':
+        placementAffinity(optarg);
+        break;
+
+      case 'N':
+        placementNuma(optarg);
+        break;
+
+      case 'r':
+        tracePath = optarg;
+        break;
+
+      case 'h':
+        help(0);
+        break;
+
+			default:
+        help(2);
+        break;
+      }
+    }
+
+  // a fração de removes é o que sobra
+  if(insertFrac < 0)
+    insertFrac = (1.0f - lookupPct) / 2;
+  insertPct = lookupPct + insertFrac;
+}
+
+/* Alocação dos nós: malloc/free ou pool por thread (-p) */
+LLNode* newNode(){
+  if(usePool)
+    return poolAlloc();
+  return malloc(sizeof(LLNode));
+}
+
+void freeNode(void* node){
+  if(usePool)
+    poolFree(node);
+  else
+    free(node);
+}
+
+/* Sanity Check */
+int isSane(){
+    int sane = TRUE;
+    LLNode* prev = sentinela;
+    LLNode* curr = prev->next;
+
+    while (curr != NULL) {
+        if ((prev->val) >= (curr->val) || curr->marked) {
+            printf("FAILED SANITY CHECK IN: %d < %d\n", prev->val, curr->val);
+            sane = FALSE;
+            break;
+        }
+        prev = curr;
+        curr = (curr->next);
+    }
+    return sane;
+}
+
+// optimistic traversal without locks; prev and curr are only trusted after
+// locking both and checking validate()
+void search(int val, LLNode** left, LLNode** right){
+  LLNode* prev = sentinela;
+  LLNode* curr = LOAD(&prev->next);
+
+  while (curr != NULL){
+    if (curr->val >= val)
+      break;
+
+    prev = curr;
+    curr = LOAD(&prev->next);
+  }
+
+  *left = prev;
+  *right = curr;
+}
+
+void lockPair(LLNode* prev, LLNode* curr){
+  pthread_mutex_lock(&prev->lock);
+  if (curr != NULL)
+    pthread_mutex_lock(&curr->lock);
+}
+
+void unlockPair(LLNode* prev, LLNode* curr){
+  if (curr != NULL)
+    pthread_mutex_unlock(&curr->lock);
+  pthread_mutex_unlock(&prev->lock);
+}
+
+// with prev and curr locked: neither was removed and they are still adjacent
+int validate(LLNode* prev, LLNode* curr){
+  return !prev->marked && (curr == NULL || !curr->marked) && (prev->next == curr);
+}
+
+// insert method; find the right place in the list, add val so that it is in
+// sorted order; if val is already in the list, exit without inserting
+void insert(int val){
+  LLNode *prev, *curr;
+
+  ebrEnter();
+  while (TRUE){
+    // traverse the list to find the insertion point
+    search(val, &prev, &curr);
+    lockPair(prev, curr);
+
+    if (!validate(prev, curr)){
+      unlockPair(prev, curr);
+      continue;
+    }
+
+    // now insert new_node between prev and curr
+    if (!curr || (curr->val > val)){
+      // ESCRITA : REGIÃO CRITICA (prev e curr travados)
+
+      LLNode* insert_point = prev;
+      LLNode* novo = newNode();
+      novo->val = val;
+      novo->marked = FALSE;
+      novo->next = curr;
+      pthread_mutex_init(&novo->lock, NULL);
+
+      STORE(&insert_point->next, novo);
+      // FIM
+    }
+    unlockPair(prev, curr);
+    break;
+  }
+  ebrExit();
+}
+
+// search function; wait-free, takes no locks and never writes to the list
+void lookup(void* arg){
+  pthread_arg* p = (pthread_arg*) arg;
+  int val = p->in;
+
+  int found = FALSE;
+
+  ebrEnter();
+  LLNode* curr = sentinela;
+  curr = LOAD(&curr->next);
+
+  while (curr != NULL) {
+    if (curr->val >= val)
+      break;
+
+    curr = LOAD(&curr->next);
+  }
+
+  found = ((curr != NULL) && (curr->val == val) && !LOAD(&curr->marked));
+  ebrExit();
+
+  p->out = found;
+}
+
+// remove a node if its value == val
+void removeNode(int val){
+  LLNode *prev, *curr;
+
+  ebrEnter();
+  while (TRUE){
+    // find the node whose val matches the request
+    search(val, &prev, &curr);
+    lockPair(prev, curr);
+
+    if (!validate(prev, curr)){
+      unlockPair(prev, curr);
+      continue;
+    }
+
+    // if we find the node, disconnect it
+    if ((curr != NULL) && (curr->val == val)) {
+      // ESCRITA : REGIÃO CRITICA (prev e curr travados)
+
+      // logical deletion first, so lookups stop reporting it
+      STORE(&curr->marked, TRUE);
+
+      LLNode* mod_point = prev;
+      STORE(&mod_point->next, curr->next);
+      unlockPair(prev, curr);
+
+      // lock-free readers may still be on curr: free it later
+      ebrRetire(curr);
+      // FIM
+      break;
+    }
+    unlockPair(prev, curr);
+    break;
+  }
+  ebrExit();
+}
+
+// print the list
+void printLista(){
+    LLNode* curr = sentinela;
+    curr = (curr->next);
+
+    printf("lista :");
+    while (curr != NULL){
+        printf(" %d ->", curr->val);
+        curr = (curr->next);
+    }
+
+    printf(" NULL\n\n");
+}
+
+void* experiment(void* arg){
+  /* Garante thread id unico para a threads */
+  pthread_mutex_lock(&mutex);
+  int tid = gtid++;
+  pthread_mutex_unlock(&mutex);
+  placementPin(tid);
+  if(usePool) poolRegister(tid);
+  ebrRegister(tid);
+
+  //printf("tid = %d\n", tid);
+  int result, val, i;
+  int op;
+  workload_t w;
+  int l_ops, l_lookups_true, l_lookups_false, l_inserts, l_removes;
+  l_ops = l_lookups_true = l_lookups_false = l_inserts = l_removes = 0;
+
+  pthread_arg* p;
+  p = malloc(sizeof(pthread_arg));
+
+  workloadThread(&w, tid);
+
+  //printf("\nAction = %f | val = %d\n", action, val);
+
+  if(num_ops != 0){
+    for(i = 0; i < num_ops / n_threads; i++){
+      op = workloadNext(&w, &val);
+
+      if (op == OP_LOOKUP) {
+        p->in = val;
+        lookup(p);
+        result = p->out;
+
+        if (result)
+          l_lookups_true++;
+        else
+          l_lookups_false++;
+
+        if(verbose) printf("%d -> lookup %d : %d\n", tid, val, result);
+      }
+      else if (op == OP_INSERT) {
+        if(verbose) printf("%d -> insert %d\n", tid, val);
+        insert(val);
+        l_inserts++;
+      }
+      else {
+        if(verbose) printf("%d -> remove %d\n", tid, val);
+        removeNode(val);
+        l_removes++;
+      }
+
+      //int sane = isSane();
+      l_ops++;
+      timerCount(tid, l_ops);
+    }
+    // Time duration mode
+  } else {
+    //printf("%d Entrou time duration mode\n",tid);
+    while(timerRunning()){
+      op = workloadNext(&w, &val);
+      if (op == OP_LOOKUP) {
+        p->in = val;
+        lookup(p);
+        result = p->out;
+
+        if (result)
+          l_lookups_true++;
+        else
+          l_lookups_false++;
+
+        if(verbose) printf("%d -> lookup %d : %d\n", tid, val, result);
+      }
+      else if (op == OP_INSERT) {
+        if(verbose) printf("%d -> insert %d\n", tid, val);
+        insert(val);
+        l_inserts++;
+      }
+      else {
+        if(verbose) printf("%d -> remove %d\n", tid, val);
+        removeNode(val);
+        l_removes++;
+      }
+
+      //int sane = isSane();
+      l_ops++;
+      timerCount(tid, l_ops);
+    }
+  }
+
+  pthread_mutex_lock(&mutex);
+  count_ops += l_ops;
+  inserts += l_inserts;
+  lookups_true += l_lookups_true;
+  lookups_false += l_lookups_false;
+  removes += l_removes;
+  pthread_mutex_unlock(&mutex);
+}
+
+/* Checa se os parametros são validos, aborta caso não sejam */
+void checkData(){
+  if(n_threads < 1){
+    printf("Número inválido de threads. Abortando...\n");
+    exit(1);
+  }
+
+	if(datasetsize < 1){
+		printf("Tamanho da lista inválida. Abortando...\n");
+		exit(1);
+	}
+
+  if(duration <=0){
+    printf("Tempo de execução inválido. Abortando...\n");
+    exit(1);
+  }
+
+  if(num_ops < 0){
+    printf("Modo Número de operações: Valor inválido. Abortando...\n");
+    exit(1);
+  }
+
+  if(lookupPct < 0 || lookupPct > 1){
+    printf("Fração de lookups inválida. Abortando...\n");
+    exit(1);
+  }
+
+  if(insertFrac < 0 || insertPct > 1.0001f){
+    printf("Fração de inserts inválida. Abortando...\n");
+    exit(1);
+  }
+
+  if(sampleMs < 0){
+    printf("Intervalo de amostragem inválido. Abortando...\n");
+    exit(1);
+  }
+
+  if(tracePath != NULL && n_threads > (int) workload.trace->n_threads){
+    printf("O trace só tem operações para %u threads. Abortando...\n", workload.trace->n_threads);
+    exit(1);
+  }
+}
+
+void printInfo(){
+  printf("\nNúmero de threads = %d", n_threads);
+  if(num_ops != 0)
+    printf("\nModo número de operações = %d operações", num_ops);
+  else
+    printf("\nModo tempo de execução = %.2lf segundos", duration);
+  printf("\nTamanho máximo da fila = %d nodes", datasetsize);
+  printf("\nPorcentagens das operações: %.2f Lookup / %.2f Insert / %.2f Remove",
+            lookupPct, insertPct - lookupPct, 1.0f - insertPct);
+  workloadPrintInfo();
+  placementPrintInfo(n_threads);
+
+  if(doWarmup)
+    printf("\nWarm Up: ativado");
+  else
+    printf("\nWarm Up: desativado");
+
+  if(usePool)
+    printf("\nAlocação de nós: pool por thread");
+  else
+    printf("\nAlocação de nós: malloc/free");
+}
+
+int main(int argc, char *argv[]) {
+  int i;
+  printf("\nLinked List - versão lazy\n");
+
+	getArgs(argc, argv);
+  placementInit();
+  workloadInit(tracePath, &datasetsize, &lookupPct, &insertPct);
+	checkData();
+  printInfo();
+
+  /* Inicializa a lista criando a sentinela */
+  sentinela = malloc(sizeof(LLNode));
+  sentinela->val = -1;
+  sentinela->marked = FALSE;
+  sentinela->next = NULL;
+  pthread_mutex_init(&sentinela->lock, NULL);
+
+  if(usePool) poolInit(n_threads, sizeof(LLNode));
+  ebrInit(n_threads, sizeof(LLNode), freeNode);
+
+  pthread_t threads[n_threads];
+  void* pth_status;
+
+  /* Warm Up */
+  // warmup inserts half of the elements in the datasetsize
+  if(doWarmup){
+      for (i = 0; i < datasetsize; i+=2) {
+        insert(i);
+      }
+  }
+
+  timerInit(n_threads, num_ops != 0 ? 0 : duration, sampleMs, seriesPath);
+  clock_gettime(CLOCK_MONOTONIC, &tstart);
+  timeDiff = 0;
+  timerStart();
+
+  printf("\n\n\t--- Rodando experimentos ---\n");
+  for(i = 0; i < n_threads; i++){
+		pthread_create(&threads[i], NULL, experiment, NULL);
+	}
+
+  //experiment(NULL);
+
+  for(i = 0; i < n_threads; i++){
+		 pthread_join(threads[i], &pth_status);
+	}
+
+  timerStop();
+  clock_gettime(CLOCK_MONOTONIC, &tend);
+  timeDiff = ((double)tend.tv_sec + 1.0e-9*tend.tv_nsec) - ((double)tstart.tv_sec + 1.0e-9*tstart.tv_nsec);
+
+  printf("\t    FIM DA EXECUÇÃO.\n");
+
+  if(verbose) printLista();
+  printf("\nSanity Check: ");
+  if(isSane())
+    printf("Passed\n");
+  else
+    printf("Failed! Isn't sane!\n");
+
+  printf("Tempo de execução dos experimentos = %lf segundos\n", timeDiff);
+  printf("Total de operações realizadas = %d\n",count_ops);
+  printf("Total de lookups acertados: %d\n", lookups_true);
+  printf("Total de lookups falhados: %d\n", lookups_false);
+  printf("Total de Inserts: %d\n", inserts);
+  printf("Total de removes: %d\n", removes);
+  timerPrintSeries();
+
+  ebrPrintStats();
+  ebrFlush();
+
+  if(usePool){
+    poolPrintStats();
+    poolDestroy();
+  }
+
+  return 0;
+}
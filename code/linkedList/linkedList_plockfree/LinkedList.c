@@ -0,0 +1,603 @@
+/* Implementação do benchmark LinkedList da RSTM em C */
+/* Autor: Bruno Cesar, @bcesarg6, bcesar.g6@gmail.com */
+/* Abril de 2018                                      */
+/* Versão Processos + Lock-free (lista de Michael com */
+/* versões nos índices, sem semáforo)                 */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include "SharedMemoryController.h"
+#include "Workload.h"
+#include "Timer.h"
+#include "Placement.h"
+
+/* Estruturas */
+typedef struct pthread_arg{
+  int in;
+  int out;
+}pthread_arg;
+
+LLNode* sentinela;
+stats_t* stats;
+sh_mem_add_t sh_mem_adds;
+
+/* Dados globais com valores padrão */
+static int datasetsize = 256;                  // number of items
+static double duration = 5.0f;                 // in seconds
+static int doWarmup = FALSE;
+static int verbose = FALSE;
+static char* tracePath = NULL;                 // trace binário para replay (-r)
+static int sampleMs = 0;                       // intervalo da série de vazão (-I)
+static char* seriesPath = NULL;                // arquivo CSV da série (-o)
+static int num_ops = 0;                        // number of operations mode value.
+static int n_threads = 2;
+static int arenaFlags = 0;                     // páginas grandes e prefault da memória compartilhada (-H, -P)
+
+// these three are for getting various lookup/insert/remove ratios
+static float lookupPct = 0.34f;
+static float insertPct = 0.67f;
+static float insertFrac = -1.0f;               // -1: metade do que sobra dos lookups
+
+// Controla o tempo de execução
+struct timespec tstart, tend;
+double timeDiff;
+
+int gtid = 0;
+
+/* Exibe ajuda e finaliza o programa */
+void help(int msg){
+  switch (msg) {
+    case 1:
+      printf("\nNúmero insuficiente de parametros!\n");
+      break;
+
+    case 2:
+      printf("\nParametros de entrada inválidos!\n");
+      break;
+
+    default:
+      break;
+  }
+
+  printf("\n\tn : Número de Processos [2]");
+	printf("\n\ts : Tamanho do datasetsize [256]");
+  printf("\n\tt : Tempo de duração da execução (segundos) [5.0]");
+  printf("\n\tw : Ativa o Warm Up antes da execução [FALSE]");
+  printf("\n\tx : Muda para o modo de execução por número de operações.");
+  printf("\n\tl : Fração de lookups [0.34]");
+  printf("\n\ti : Fração de inserts, o resto são removes [metade do que sobra dos lookups]");
+  printf("\n\tk : Distribuição das chaves: uniform, zipf[:theta], hotspot[:chaves[:ops]] ou seq [uniform]");
+  printf("\n\tr : Reproduz as operações de um trace gerado pelo tracegen");
+  printf("\n\tI : Amostra a vazão de cada thread a cada I ms [desativado]");
+  printf("\n\to : Grava a série de vazão em um arquivo CSV em vez da saída padrão");
+  printf("\n\ta : Afinidade: compact, scatter ou list:0,2,4-7 [nenhuma]");
+  printf("\n\tN : Política de memória NUMA: local ou interleave [padrão do sistema]");
+  printf("\n\tH : Páginas grandes na memória compartilhada: hugetlbfs, ou THP se não houver páginas reservadas");
+  printf("\n\tP : Toca todas as páginas da memória compartilhada antes da execução");
+  printf("\n\tv : Ativa o modo verbose.");
+  printf("\n\th : Mostra essa mensagem\n\n");
+	exit(1);
+}
+
+/* Pega argumentos com getopt */
+void getArgs(int argc, char *argv[]){
+	extern char *optarg;
+	char op;
+
+	struct option longopts[] = {
+    {"n_threads", 1, NULL, 'n'},
+    {"size", 1, NULL, 's'},
+    {"time", 1, NULL, 't'},
+    {"warmup", 0, NULL, 'w'},
+    {"verbose", 0, NULL, 'v'},
+    {"replay", 1, NULL, 'r'},
+    {"lookup", 1, NULL, 'l'},
+    {"insert", 1, NULL, 'i'},
+    {"keys", 1, NULL, 'k'},
+    {"interval", 1, NULL, 'I'},
+    {"series", 1, NULL, 'o'},
+    {"affinity", 1, NULL, 'a'},
+    {"numa", 1, NULL, 'N'},
+    {"hugepages", 0, NULL, 'H'},
+    {"prefault", 0, NULL, 'P'},
+    {"x", 1, NULL, 'x'}
+	};
+
+	while ((op = getopt_long(argc, argv, "n:s:t:wvx:l:i:k:r:I:o:a:N:HPh", longopts, NULL)) != -1) {
+		switch (op) {
+      case 'n':
+        n_threads = atoi(optarg);
+        break;
+
+			case 's':
+				datasetsize = atoi(optarg);
+				break;
+
+      case 't':
+        duration = atof(optarg);
+        break;
+
+      case 'w':
+        doWarmup = TRUE;
+        break;
+
+      case 'v':
+        verbose = TRUE;
+        break;
+
+      case 'x':
+        num_ops = atoi(optarg);
+        break;
+
+      case 'l':
+        lookupPct = atof(optarg);
+        break;
+
+      case 'i':
+        insertFrac = atof(optarg);
+        break;
+
+      case 'k':
+        workloadDist(optarg);
+        break;
+
+      case 'I':
+        sampleMs = atoi(optarg);
+        break;
+
+      case 'o':
+        seriesPath = optarg;
+        break;
+
+      case 'a':
+        placementAffinity(optarg);
+        break;
+
+      case 'N':
+        placementNuma(optarg);
+        break;
+
+      case 'H':
+        arenaFlags |= ARENA_HUGEPAGES;
+        break;
+
+      case 'P':
+        arenaFlags |= ARENA_PREFAULT;
+        break;
+
+      case 'r':
+        tracePath = optarg;
+        break;
+
+      case 'h':
+        help(0);
+        break;
+
+			default:
+        help(2);
+        break;
+      }
+    }
+
+  // a fração de removes é o que sobra
+  if(insertFrac < 0)
+    insertFrac = (1.0f - lookupPct) / 2;
+  insertPct = lookupPct + insertFrac;
+}
+
+/* Checa se os parametros são validos, aborta caso não sejam */
+void checkData(){
+  if(n_threads < 1){
+    printf("Número inválido de threads. Abortando...\n");
+    exit(1);
+  }
+
+	if(datasetsize < 1){
+		printf("Tamanho da lista inválida. Abortando...\n");
+		exit(1);
+	}
+
+  if(duration <=0){
+    printf("Tempo de execução inválido. Abortando...\n");
+    exit(1);
+  }
+
+  if(num_ops < 0){
+    printf("Modo Número de operações: Valor inválido. Abortando...\n");
+    exit(1);
+  }
+
+  if(lookupPct < 0 || lookupPct > 1){
+    printf("Fração de lookups inválida. Abortando...\n");
+    exit(1);
+  }
+
+  if(insertFrac < 0 || insertPct > 1.0001f){
+    printf("Fração de inserts inválida. Abortando...\n");
+    exit(1);
+  }
+
+  if(sampleMs < 0){
+    printf("Intervalo de amostragem inválido. Abortando...\n");
+    exit(1);
+  }
+
+  if(tracePath != NULL && n_threads > (int) workload.trace->n_threads){
+    printf("O trace só tem operações para %u threads. Abortando...\n", workload.trace->n_threads);
+    exit(1);
+  }
+}
+
+/* Sanity Check */
+int isSane(){
+    int sane = TRUE;
+    LLNode* prev = sentinela;
+    LLNode* curr = getNode(refId(prev->next));
+
+    while (curr != NULL) {
+        if ((prev->val) >= (curr->val)) {
+            printf("FAILED SANITY CHECK IN: %d < %d\n", prev->val, curr->val);
+            sane = FALSE;
+            break;
+        }
+        prev = curr;
+        curr = getNode(refId(curr->next));
+    }
+    return sane;
+}
+
+// Michael's search, with version tags instead of hazard pointers: nodes are
+// recycled but never unmapped, so reading a stale one is harmless, and every
+// step is validated by re-reading the word that led to it. Unlinks the
+// marked nodes it meets. On return *prev is the word that points to the
+// first node with val >= val (the id in *pcur, -1 at the end) and *cnext is
+// that node's next
+static int find(int val, sh_ref_t** prev, sh_ref_t* pcur, sh_ref_t* cnext){
+  sh_ref_t *p, pc, cn;
+  LLNode* curr;
+  int ckey;
+
+retry:
+  p = &sentinela->next;
+  pc = LOAD(p);
+
+  while (refId(pc) != -1){
+    curr = getNode(refId(pc));
+    cn = LOAD(&curr->next);
+    ckey = LOAD(&curr->val);
+
+    // curr and its key are only meaningful if p still points to it
+    if (LOAD(p) != pc)
+      goto retry;
+
+    if (refMark(cn)){
+      // curr was logically deleted; unlink it and recycle it
+      if (!CAS(p, pc, makeRef(refId(cn), 0, refTag(pc) + 1)))
+        goto retry;
+
+      shFree(refId(pc));
+      pc = makeRef(refId(cn), 0, refTag(pc) + 1);
+      continue;
+    }
+
+    if (ckey >= val){
+      *prev = p;
+      *pcur = pc;
+      *cnext = cn;
+      return ckey == val;
+    }
+
+    p = &curr->next;
+    pc = cn;
+  }
+
+  *prev = p;
+  *pcur = pc;
+  return FALSE;
+}
+
+// insert method; find the right place in the list, add val so that it is in
+// sorted order; if val is already in the list, exit without inserting
+void insert(int val, int* done){
+  sh_ref_t *prev, pcur, cnext, old;
+  LLNode* novo = NULL;
+  int id;
+
+  *done = 1;
+  while (TRUE){
+    if (find(val, &prev, &pcur, &cnext)){
+      if (novo)
+        shFree(id);
+      return;
+    }
+
+    if (novo == NULL){
+      novo = shAlloc(&id);
+      if(id == -1){
+        *done = 0;
+        printf("Número máximo de nós alcançado\n");
+        return;
+      }
+      novo->id = id;
+      STORE(&novo->val, val);
+    }
+
+    // now link novo between prev and curr; fails if prev was marked or
+    // changed in the meantime. novo's own next keeps counting versions
+    old = LOAD(&novo->next);
+    STORE(&novo->next, makeRef(refId(pcur), 0, refTag(old) + 1));
+    if (CAS(prev, pcur, makeRef(id, 0, refTag(pcur) + 1)))
+      return;
+  }
+}
+
+// search function
+void lookup(void* arg){
+  pthread_arg* p = (pthread_arg*) arg;
+  sh_ref_t *prev, pcur, cnext;
+
+  p->out = find(p->in, &prev, &pcur, &cnext);
+}
+
+// remove a node if its value == val
+void removeNode(int val){
+  sh_ref_t *prev, pcur, cnext;
+  LLNode* curr;
+
+  while (TRUE){
+    // this means the search failed
+    if (!find(val, &prev, &pcur, &cnext))
+      return;
+
+    // logical deletion: mark curr->next so no one links after curr anymore
+    curr = getNode(refId(pcur));
+    if (!CAS(&curr->next, cnext, makeRef(refId(cnext), 1, refTag(cnext) + 1)))
+      continue;
+
+    // physical deletion; if it fails, find unlinks curr for us
+    if (CAS(prev, pcur, makeRef(refId(cnext), 0, refTag(pcur) + 1)))
+      shFree(refId(pcur));
+    else
+      find(val, &prev, &pcur, &cnext);
+    return;
+  }
+}
+
+// print the list
+void printLista(){
+    LLNode* curr = sentinela;
+    //printNode(sentinela);
+    curr = getNode(refId(curr->next));
+
+    printf("lista :");
+    while (curr != NULL){
+        printf(" %d ->", curr->val);
+        curr = getNode(refId(curr->next));
+    }
+
+    printf(" NULL\n\n");
+}
+
+void* experiment(void* arg, int tid){
+  int result, val, i, done;
+  int op;
+  workload_t w;
+  int l_ops, l_lookups_true, l_lookups_false, l_inserts, l_removes;
+  l_ops = l_lookups_true = l_lookups_false = l_inserts = l_removes = 0;
+
+  pthread_arg* p;
+  p = malloc(sizeof(pthread_arg));
+
+  placementPin(tid);
+  workloadThread(&w, tid);
+
+  //printf("\nAction = %f | val = %d\n", action, val);
+
+  if(num_ops != 0){
+    for(i = 0; i < num_ops / n_threads; i++){
+      op = workloadNext(&w, &val);
+
+      if (op == OP_LOOKUP) {
+        p->in = val;
+        lookup(p);
+        result = p->out;
+
+        if (result)
+          l_lookups_true++;
+        else
+          l_lookups_false++;
+        if(verbose) printf("%d -> lookup %d : %d\n", tid, val, result);
+
+      } else if (op == OP_INSERT) {
+        if(verbose) printf("%d -> insert %d\n", tid, val);
+        insert(val, &done);
+        if(done)
+          l_inserts++;
+
+      } else {
+        if(verbose) printf("%d -> remove %d\n", tid, val);
+        removeNode(val);
+        l_removes++;
+      }
+
+      l_ops++;
+      timerCount(tid, l_ops);
+    }
+  } else {
+    // Time duration mode
+    while(timerRunning()){
+      op = workloadNext(&w, &val);
+
+      if (op == OP_LOOKUP) {
+        p->in = val;
+        lookup(p);
+        result = p->out;
+
+        if (result)
+          l_lookups_true++;
+        else
+          l_lookups_false++;
+
+        if(verbose) printf("%d -> lookup %d : %d\n", tid, val, result);
+
+      } else if (op == OP_INSERT) {
+        if(verbose) printf("%d -> insert %d\n", tid, val);
+        insert(val, &done);
+        if(done)
+          l_inserts++;
+
+      } else {
+        if(verbose) printf("%d -> remove %d\n", tid, val);
+        removeNode(val);
+        l_removes++;
+      }
+
+      l_ops++;
+      timerCount(tid, l_ops);
+    }
+  }
+
+  __atomic_fetch_add(&stats->count_ops, l_ops, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&stats->inserts, l_inserts, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&stats->lookups_true, l_lookups_true, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&stats->lookups_false, l_lookups_false, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&stats->removes, l_removes, __ATOMIC_RELAXED);
+
+  exit(0);
+}
+
+void printNode(LLNode* node){
+  printf("Dados do nó\n");
+  printf("ID: %d\n", node->id);
+  printf("VAL: %d\n", node->val);
+  printf("NEXT: %d (versão %u%s)\n", refId(node->next), refTag(node->next),
+         refMark(node->next) ? ", removido" : "");
+
+}
+
+void printInfo(){
+  printf("\nNúmero de threads = %d", n_threads);
+  if(num_ops != 0)
+    printf("\nModo número de operações = %d operações", num_ops);
+  else
+    printf("\nModo tempo de execução = %.2lf segundos", duration);
+
+  printf("\nTamanho máximo da lista = %d nodes", datasetsize);
+  printf("\nPorcentagens das operações: %.2f Lookup / %.2f Insert / %.2f Remove",
+            lookupPct, insertPct - lookupPct, 1.0f - insertPct);
+  workloadPrintInfo();
+  placementPrintInfo(n_threads);
+
+  if(doWarmup)
+    printf("\nWarm Up: ativado");
+  else
+    printf("\nWarm Up: desativado");
+}
+
+int main(int argc, char *argv[]) {
+  int i, done, pid = 0, id = -1;
+  printf("\nLinked List - versão Processos + Lock-free\n");
+
+	getArgs(argc, argv);
+  placementInit();
+  workloadInit(tracePath, &datasetsize, &lookupPct, &insertPct);
+	checkData();
+  printInfo();
+
+  /* Inicializa a lista criando a sentinela */
+  sentinela = malloc(sizeof(LLNode));
+
+  timerInit(n_threads, num_ops != 0 ? 0 : duration, sampleMs, seriesPath);
+  clock_gettime(CLOCK_MONOTONIC, &tstart);
+  timeDiff = 0;
+
+  /* SHM */
+  printf("\n\n\t--- Rodando experimentos ---\n");
+
+  createShMem(datasetsize, arenaFlags); //pedaços de datasetsize nós, mais são criados quando acabam
+  stats = sh_mem_adds.stats_add;
+
+  sentinela = shAlloc(&id);
+  sentinela->val = -1;
+  sentinela->next = makeRef(-1, 0, 0);
+  sentinela->id = id;
+
+  /* Warm Up */
+  // warmup inserts half of the elements in the datasetsize
+  if(doWarmup){
+      for (i = 0; i < datasetsize; i+=2) {
+        insert(i, &done);
+      }
+  }
+
+  //FORK
+  for(i = 0; i < n_threads; i++){
+    pid = fork();
+    if(pid == -1){
+      printf("Erro ao criar processo, abortando\n");
+      exit(1);
+    }
+    else if(!pid){
+      break;
+    }
+    else{
+      if(verbose) printf("Filho %d criado\n", pid);
+    }
+  }
+
+  if(!pid){
+    //printf("Iniciando processo filho\n");
+    //A partir daqui todos o processos executam isso
+    //A arena foi mapeada antes do fork: sentinela e stats já valem aqui
+    //printf("%d %d\n", getpid(), sh_mem_adds.node_mem_add);
+    //printNode(sentinela);
+
+    experiment(NULL, i);
+  }
+  else{
+    // o timer roda no pai, os filhos só leem a flag compartilhada
+    timerStart();
+    if(verbose) printf("Pai esperando\n");
+    for(int i = 0; i < n_threads; i++){
+      waitpid(-1, NULL, 0);
+    }
+    timerStop();
+    if(verbose) printf("Pai terminou\n");
+  }
+
+  //FORK "join"
+
+  /* SHM_END */
+
+  clock_gettime(CLOCK_MONOTONIC, &tend);
+  timeDiff = ((double)tend.tv_sec + 1.0e-9*tend.tv_nsec) - ((double)tstart.tv_sec + 1.0e-9*tstart.tv_nsec);
+
+  printf("\t    FIM DA EXECUÇÃO.\n");
+
+  if(verbose) printLista();
+
+  printf("\nSanity Check: ");
+  if(isSane())
+    printf("Passou\n");
+  else
+    printf("Falhou!\n");
+
+  printf("Tempo de execução dos experimentos = %lf segundos\n", timeDiff);
+  printf("Total de operações realizadas = %d\n",stats->count_ops);
+  printf("Total de lookups acertados: %d\n", stats->lookups_true);
+  printf("Total de lookups falhados: %d\n", stats->lookups_false);
+  printf("Total de Inserts: %d\n", stats->inserts);
+  printf("Total de removes: %d\n", stats->removes);
+  arenaPrintInfo();
+  shPrintInfo();
+  timerPrintSeries();
+
+  return 0;
+}
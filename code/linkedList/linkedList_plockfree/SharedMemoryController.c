@@ -0,0 +1,135 @@
+/* Gerenciador de memoria compartilhada entre processos */
+/* Autor: Bruno Cesar, @bcesarg6, bcesar.g6@gmail.com   */
+/* 		  Cristofer Alexandre Oswald 				    */
+/* Maio de 2018   */
+/* Versão lock-free: alocação por contador atômico e pilha de Treiber */
+/* com versão, sem semáforo                                         */
+
+#include "SharedMemoryController.h"
+
+sh_mem_t* createShMem(int n_nodes, int arena_flags){
+	sh_mem_t* ctrl;
+	size_t size;
+	int shift;
+
+	for(shift = SH_MIN_CHUNK_SHIFT; (1 << shift) < n_nodes; shift++)
+		;
+
+	//Uma arena só para tudo, cada parte na sua linha de cache; o pedaço 0
+	//de nós vem junto, os outros são acrescentados ao memfd depois dela
+	size = ARENA_ALIGN(sizeof(sh_mem_t)) + ARENA_ALIGN(sizeof(stats_t))
+			 + ARENA_ALIGN(sizeof(LLNode) << shift);
+	arenaCreate(size, arena_flags);
+
+	//A arena vem zerada: estatísticas em 0
+	ctrl = arenaCarve(sizeof(sh_mem_t));
+	sh_mem_adds.ctrl_add = ctrl;
+	sh_mem_adds.stats_add = arenaCarve(sizeof(stats_t));
+	sh_mem_adds.chunks[0] = arenaCarve(sizeof(LLNode) << shift);
+	sh_mem_adds.chunk_shift = shift;
+	sh_mem_adds.chunk_mask = (1 << shift) - 1;
+
+	ctrl->chunk_shift = shift;
+	ctrl->max_chunks = shift > 21 ? 1 << (31 - shift) : SH_MAX_CHUNKS;
+	ctrl->chunk_bytes = (((sizeof(LLNode) << shift) + arena.page - 1) / arena.page) * arena.page;
+	ctrl->chunk_base = arena.size;
+	ctrl->next_node = 0;
+	ctrl->free_top = makeRef(-1, 0, 0);
+
+	return ctrl;
+}
+
+//Mapeia neste processo um pedaço criado por qualquer um deles
+static LLNode* mapChunk(int chunk){
+	sh_mem_t* ctrl = sh_mem_adds.ctrl_add;
+
+	sh_mem_adds.chunks[chunk] = arenaMap(ctrl->chunk_base + (chunk - 1) * ctrl->chunk_bytes,
+																			 ctrl->chunk_bytes);
+	return sh_mem_adds.chunks[chunk];
+}
+
+LLNode* shAlloc(int* id){
+	sh_mem_t* ctrl;
+	sh_ref_t top, next;
+	LLNode* node;
+	long n;
+	int chunk;
+
+	ctrl = sh_mem_adds.ctrl_add;
+
+	//Pilha de Treiber: a versão do topo impede que um pop atrasado ponha
+	//no topo um next que já não vale
+	top = LOAD(&ctrl->free_top);
+	while(refId(top) != -1){
+		node = getNode(refId(top));
+		next = LOAD(&node->next);
+		if(CAS(&ctrl->free_top, top, makeRef(refId(next), 0, refTag(top) + 1))){
+			*id = refId(top);
+			return node;
+		}
+		top = LOAD(&ctrl->free_top);
+	}
+
+	n = __atomic_fetch_add(&ctrl->next_node, 1, __ATOMIC_RELAXED);
+	chunk = n >> ctrl->chunk_shift;
+	if(chunk >= ctrl->max_chunks){
+		printf("Número máximo de nós alcançado\n");
+		*id = -1;
+
+		return NULL;
+	}
+
+	//Quem pega um id de um pedaço que ainda não mapeou garante o pedaço;
+	//o fallocate é idempotente, então não importa quem chega primeiro
+	if(sh_mem_adds.chunks[chunk] == NULL){
+		arenaExtend(ctrl->chunk_base + (chunk - 1) * ctrl->chunk_bytes, ctrl->chunk_bytes);
+		mapChunk(chunk);
+	}
+
+	*id = (int) n;
+	return getNode(*id);
+}
+
+//Os ids lidos da lista são de nós já publicados, então o pedaço existe
+LLNode* getNode(int id){
+	LLNode* chunk;
+
+	if(id == -1)
+		return NULL;
+
+	chunk = sh_mem_adds.chunks[id >> sh_mem_adds.chunk_shift];
+	if(chunk == NULL)
+		chunk = mapChunk(id >> sh_mem_adds.chunk_shift);
+	return chunk + (id & sh_mem_adds.chunk_mask);
+}
+
+//Só quem desligou o nó da lista o devolve. Leitores atrasados ainda podem
+//passar por ele, mas a versão nova do next faz a validação deles falhar
+void shFree(int id){
+	sh_mem_t* ctrl;
+	sh_ref_t top, old;
+	LLNode* node;
+
+	ctrl = sh_mem_adds.ctrl_add;
+	node = getNode(id);
+	old = LOAD(&node->next);
+
+	do{
+		top = LOAD(&ctrl->free_top);
+		STORE(&node->next, makeRef(refId(top), 0, refTag(old) + 1));
+	}while(!CAS(&ctrl->free_top, top, makeRef(id, 0, refTag(top) + 1)));
+}
+
+//Só com os processos parados
+void shPrintInfo(){
+	sh_mem_t* ctrl = sh_mem_adds.ctrl_add;
+	int free_nodes = 0, id;
+	long used = ctrl->next_node;
+
+	for(id = refId(ctrl->free_top); id != -1; id = refId(getNode(id)->next))
+		free_nodes++;
+
+	printf("Heap de nós: %ld pedaço(s) de %d nós, %ld nós usados, %d na lista livre\n",
+				 (used + (1 << ctrl->chunk_shift) - 1) >> ctrl->chunk_shift, 1 << ctrl->chunk_shift,
+				 used, free_nodes);
+}
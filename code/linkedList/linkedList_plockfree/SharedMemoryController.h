@@ -0,0 +1,87 @@
+#ifndef SHAREDMEMORYCONTROLLER_H
+#define SHAREDMEMORYCONTROLLER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include "ShArena.h"
+
+#define TRUE 1
+#define FALSE 0
+
+/* Referência a um nó numa palavra de 64 bits: (versão << 32) | (id << 1) | marca.
+   Toda troca aumenta a versão, então um CAS com uma leitura antiga falha
+   mesmo que o mesmo id tenha voltado ao lugar (ABA) */
+typedef uint64_t sh_ref_t;
+
+#define REF_NULL 0x7FFFFFFFU       // id -1
+#define makeRef(id, mark, tag) ((((uint64_t) (tag)) << 32) | ((((uint32_t) (id)) & REF_NULL) << 1) | (mark))
+#define refId(r) ((((uint32_t) (r)) >> 1) == REF_NULL ? -1 : (int) (((uint32_t) (r)) >> 1))
+#define refMark(r) ((int) ((r) & 1))
+#define refTag(r) ((uint32_t) ((r) >> 32))
+
+#define CAS(addr, expected, desired) \
+  __atomic_compare_exchange_n((addr), &(sh_ref_t){(expected)}, (desired), FALSE, \
+                              __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#define LOAD(addr) __atomic_load_n((addr), __ATOMIC_ACQUIRE)
+#define STORE(addr, v) __atomic_store_n((addr), (v), __ATOMIC_RELEASE)
+
+typedef struct LLNode {
+    int id;
+    int val;
+    sh_ref_t next;              // marcado quando o nó foi removido logicamente
+} LLNode;
+
+typedef struct stats_t{
+  int count_ops;
+  int inserts;
+  int lookups_true;
+  int lookups_false;
+  int removes;
+} stats_t;
+
+/* Os nós ficam em pedaços de 2^chunk_shift nós, criados sob demanda; o id
+   de um nó é (pedaço << chunk_shift) | posição no pedaço */
+#define SH_MAX_CHUNKS 1024
+#define SH_MIN_CHUNK_SHIFT 10
+
+/* Controle da memória de nós, na arena compartilhada; os dois contadores
+   disputados ficam cada um na sua linha de cache */
+typedef struct sh_mem_t{
+  int chunk_shift;
+  int max_chunks;               // o id tem que caber em 31 bits
+  size_t chunk_bytes;           // múltiplo da página da arena
+  size_t chunk_base;            // deslocamento no memfd do pedaço 1; o 0 vem com a arena
+  long next_node __attribute__((aligned(CACHE_LINE)));   // próximo id ainda não usado
+  sh_ref_t free_top __attribute__((aligned(CACHE_LINE))); // topo da pilha livre, ligada pelo next
+} sh_mem_t;
+
+/* Endereços neste processo; o mapeamento da arena é herdado pelo fork, os
+   pedaços criados depois são mapeados por cada processo ao encontrá-los */
+typedef struct sh_mem_add_t{
+  sh_mem_t* ctrl_add;
+  stats_t* stats_add;
+  int chunk_shift;              // cópias locais de ctrl, para getNode não ler a memória compartilhada
+  int chunk_mask;
+  LLNode* chunks[SH_MAX_CHUNKS];
+} sh_mem_add_t;
+
+
+extern sh_mem_add_t sh_mem_adds;
+
+/* Os pedaços têm n_nodes nós, arredondado para potência de 2 */
+sh_mem_t* createShMem(int n_nodes, int arena_flags);
+
+LLNode* shAlloc(int* id);
+
+void shFree(int id);
+
+LLNode* getNode(int id);
+
+void shPrintInfo();
+
+void printNode(LLNode* node);
+
+void printLista();
+#endif
@@ -5,172 +5,202 @@
 
 #include "SharedMemoryController.h"
 
-sh_mem_t* createShMem(int n_nodes){
+sh_mem_t* createShMem(int n_nodes, int n_procs, int arena_flags){
 	sh_mem_t* ctrl;
+	size_t size;
+	int shift, i;
+
+	for(shift = SH_MIN_CHUNK_SHIFT; (1 << shift) < n_nodes; shift++)
+		;
+
+	//Uma arena só para tudo, cada parte na sua linha de cache; o pedaço 0
+	//de nós vem junto, os outros são acrescentados ao memfd depois dela
+	size = ARENA_ALIGN(sizeof(sh_mem_t)) + ARENA_ALIGN(sizeof(stats_t))
+			 + ARENA_ALIGN(sizeof(sh_shard_t) * (n_procs + 1))
+			 + ARENA_ALIGN(sizeof(sem_add)) + ARENA_ALIGN(sizeof(LLNode) << shift);
+	arenaCreate(size, arena_flags);
+
+	//A arena vem zerada: lista livre vazia, estatísticas em 0
+	ctrl = arenaCarve(sizeof(sh_mem_t));
+	sh_mem_adds.ctrl_add = ctrl;
+	sh_mem_adds.stats_add = arenaCarve(sizeof(stats_t));
+	sh_mem_adds.shards = arenaCarve(sizeof(sh_shard_t) * (n_procs + 1));
+	for(i = 0; i <= n_procs; i++)
+		sh_mem_adds.shards[i].head = -1;
+	sh_mem_adds.shard = &sh_mem_adds.shards[n_procs];
+	sem = arenaCarve(sizeof(sem_add));
+	sh_mem_adds.chunks[0] = arenaCarve(sizeof(LLNode) << shift);
+	sh_mem_adds.chunk_shift = shift;
+	sh_mem_adds.chunk_mask = (1 << shift) - 1;
+
+	ctrl->chunk_shift = shift;
+	ctrl->max_chunks = shift > 21 ? 1 << (31 - shift) : SH_MAX_CHUNKS;
+	ctrl->n_chunks = 1;
+	ctrl->mem_ptr = 0;
+	ctrl->free_list_size = 0;
+	ctrl->next_free_id = -1;
+	ctrl->n_shards = n_procs + 1;
+	ctrl->chunk_bytes = (((sizeof(LLNode) << shift) + arena.page - 1) / arena.page) * arena.page;
+	ctrl->chunk_base = arena.size;
 
-	//Cria a estrutura controladora da memória
-	if ((mem_ctrl_id = shmget(IPC_PRIVATE, sizeof(sh_mem_t), (SHM_R | SHM_W))) < 0){
-		printf("Falha ao criar estrutura de memória compartilhada\n");
-		exit(1);
-	}
+	return ctrl;
+}
 
-	if ((ctrl = shmat(mem_ctrl_id, NULL, 0)) == (void*) -1){
-		printf("Falha ao ler estrutura de memória compartilhada na criação\n");
-		exit(1);
-	}
-	shmctl(mem_ctrl_id, IPC_RMID, (struct shmid_ds *) NULL);
+//Mapeia neste processo um pedaço criado por qualquer um deles
+static LLNode* mapChunk(int chunk){
+	sh_mem_t* ctrl = sh_mem_adds.ctrl_add;
 
-	ctrl->n_nodes = n_nodes;
+	sh_mem_adds.chunks[chunk] = arenaMap(ctrl->chunk_base + (chunk - 1) * ctrl->chunk_bytes,
+																			 ctrl->chunk_bytes);
+	return sh_mem_adds.chunks[chunk];
+}
 
-	//Cria a memória especificada
-	if ((ctrl->node_mem_shmid = shmget(IPC_PRIVATE, (sizeof(LLNode) * n_nodes), (SHM_R | SHM_W))) < 0){
-		printf("Falha ao criar memória compartilhada de nós\n");
-		exit(1);
-	}
+//Acrescenta um pedaço ao memfd; chamada com o semáforo da lista
+static int growHeap(){
+	sh_mem_t* ctrl = sh_mem_adds.ctrl_add;
+	int chunk = ctrl->n_chunks;
 
+	if(chunk == ctrl->max_chunks)
+		return 0;
+
+	arenaExtend(ctrl->chunk_base + (chunk - 1) * ctrl->chunk_bytes, ctrl->chunk_bytes);
+	mapChunk(chunk);
+	ctrl->n_chunks = chunk + 1;
 	ctrl->mem_ptr = 0;
+	return 1;
+}
 
-	//Cria lista de endereços de memória livres
-	if ((ctrl->free_list_shmid = shmget(IPC_PRIVATE, (sizeof(free_id_t) * n_nodes), (SHM_R | SHM_W))) < 0){
-		printf("Falha ao criar lista de memória livre\n");
-		exit(1);
-	}
+void shRegister(int tid){
+	sh_mem_adds.shard = &sh_mem_adds.shards[tid];
+}
 
-	//Cria estrutura para estatísticas
-	if ((ctrl->stats_shmid = shmget(IPC_PRIVATE, sizeof(stats_t), (SHM_R | SHM_W))) < 0){
-		printf("Falha ao criar estrutura para estatísticas\n");
-		exit(1);
-	}
+//Passa até n nós do começo de uma lista livre para o começo de outra
+static int moveNodes(int* from, int* from_size, int* to, int* to_size, int n){
+	int first = *from, last = -1, moved = 0;
 
-	if ((ctrl->sem_id = shmget(IPC_PRIVATE, sizeof(sem_add), (SHM_R | SHM_W))) < 0){
-		printf("Falha ao criar estrutura para estatísticas\n");
-		exit(1);
+	while(moved < n && *from != -1){
+		last = *from;
+		*from = getNode(last)->next;
+		moved++;
 	}
 
-	if ((ctrl->shid_id = shmget(IPC_PRIVATE, sizeof(int), (SHM_R | SHM_W))) < 0){
-		printf("Falha ao criar estrutura para estatísticas\n");
-		exit(1);
+	if(moved > 0){
+		getNode(last)->next = *to;
+		*to = first;
+		*from_size -= moved;
+		*to_size += moved;
 	}
+	return moved;
+}
 
-	ctrl->free_list_size = 0;
-	ctrl->next_free_id = -1;
+//Sem nós no pool nem no pedaço atual: antes de crescer o heap, pega metade
+//da maior lista livre dos outros processos
+static int steal(sh_shard_t* shard){
+	sh_shard_t* victim = NULL;
+	int i, n;
 
-	return ctrl;
+	for(i = 0; i < sh_mem_adds.ctrl_add->n_shards; i++){
+		if(&sh_mem_adds.shards[i] != shard && sh_mem_adds.shards[i].size > 0 &&
+			 (victim == NULL || sh_mem_adds.shards[i].size > victim->size))
+			victim = &sh_mem_adds.shards[i];
+	}
+	if(victim == NULL)
+		return 0;
+
+	n = (victim->size + 1) / 2;
+	return moveNodes(&victim->head, &victim->size, &shard->head, &shard->size,
+									 n < SH_SHARD_BATCH ? n : SH_SHARD_BATCH);
 }
 
 LLNode* shAlloc(int* id){
-	int mem_id = -1;
 	sh_mem_t* ctrl;
-	free_id_t* free_list;
-  LLNode* node;
-	free_id_t next_free_id;
+	sh_shard_t* shard;
+	LLNode* node;
 
 	ctrl = sh_mem_adds.ctrl_add;
+	shard = sh_mem_adds.shard;
+	shard->allocs++;
 
-	if(ctrl->free_list_size > 0){
-		free_list = sh_mem_adds.free_list_add;
+	//A lista do processo primeiro; o pool global só é tocado uma vez por lote
+	if(shard->size > 0)
+		shard->hits++;
+	else if(moveNodes(&ctrl->next_free_id, &ctrl->free_list_size,
+										&shard->head, &shard->size, SH_SHARD_BATCH) > 0)
+		shard->refills++;
+	else if(ctrl->mem_ptr > sh_mem_adds.chunk_mask && steal(shard) > 0)
+		shard->steals++;
 
-		next_free_id = free_list[ctrl->next_free_id];
-		ctrl->next_free_id = next_free_id.previous;
-		ctrl->free_list_size--;
+	if(shard->size > 0){
+		*id = shard->head;
+		node = getNode(*id);
+		shard->head = node->next;
+		shard->size--;
 
-		mem_id = next_free_id.id;
+		return node;
 	}
 
-	node = sh_mem_adds.node_mem_add;
-
-	if(mem_id == -1){
-		if((*sh_mem_adds.id) == ctrl->n_nodes){
-			printf("Número máximo de nós alcançado\n");
-			*id = -1;
+	if(ctrl->mem_ptr > sh_mem_adds.chunk_mask && !growHeap()){
+		printf("Número máximo de nós alcançado\n");
+		*id = -1;
 
-			return NULL;
-		}
-
-		node = node + ctrl->mem_ptr;
-		ctrl->mem_ptr = ctrl->mem_ptr + 1;
-
-		*id = *sh_mem_adds.id;
-		(*sh_mem_adds.id)++;
-	}
-	else{
-		node = node + mem_id;
-		*id = mem_id;
+		return NULL;
 	}
 
-	return node;
+	*id = ((ctrl->n_chunks - 1) << ctrl->chunk_shift) | ctrl->mem_ptr;
+	ctrl->mem_ptr = ctrl->mem_ptr + 1;
+
+	return getNode(*id);
 }
 
 LLNode* getNode(int id){
+	LLNode* chunk;
+
 	if(id == -1)
 		return NULL;
-	return (sh_mem_adds.node_mem_add + id);
-}
-
-void shFree(int id){
-	void* mem;
-	sh_mem_t* ctrl;
-
-	ctrl = sh_mem_adds.ctrl_add;
 
-	mem = sh_mem_adds.free_list_add;
-
-	((free_id_t*)mem)[id].previous = ctrl->next_free_id;
-	((free_id_t*)mem)[id].id = id;
-	ctrl->next_free_id = id;
-	ctrl->free_list_size++;
+	chunk = sh_mem_adds.chunks[id >> sh_mem_adds.chunk_shift];
+	if(chunk == NULL)
+		chunk = mapChunk(id >> sh_mem_adds.chunk_shift);
+	return chunk + (id & sh_mem_adds.chunk_mask);
 }
 
-void getMemAdds(int ct, int set_id){
-	sh_mem_t* ctrl;
-
-	if(ct){
-		if((sh_mem_adds.ctrl_add = shmat(mem_ctrl_id, NULL, 0)) == (void*) -1){
-			printf("Falha ao ler estrutura de memória compartilhada\n");
-			exit(1);
-		}
-		shmctl(mem_ctrl_id, IPC_RMID, (struct shmid_ds *) NULL);
-	}
-	ctrl = sh_mem_adds.ctrl_add;
-
-
-	if((sh_mem_adds.free_list_add = shmat(ctrl->free_list_shmid,
-																				NULL, 0)) == (void*) -1){
-		printf("Falha ao ler lista de memória livre, id: %d\n", ctrl->free_list_shmid);
-		exit(1);
-	}
-	shmctl(ctrl->free_list_shmid, IPC_RMID, (struct shmid_ds *) NULL);
-
-	if((sh_mem_adds.node_mem_add = shmat(ctrl->node_mem_shmid,
-																			 NULL, 0)) == (void*) -1){
-		printf("Falha ao ler memória compartilhada de nós\n");
-		exit(1);
-	}
-	shmctl(ctrl->node_mem_shmid, IPC_RMID, (struct shmid_ds *) NULL);
+//O nó removido já saiu da lista, então o next dele encadeia a lista livre
+void shFree(int id){
+	sh_shard_t* shard;
+	LLNode* node;
 
-	if((sh_mem_adds.stats_add = shmat(ctrl->stats_shmid,
-																			 NULL, 0)) == (void*) -1){
-		printf("Falha ao ler estrutura de estatísticas\n");
-		exit(1);
-	}
-	shmctl(ctrl->stats_shmid, IPC_RMID, (struct shmid_ds *) NULL);
+	shard = sh_mem_adds.shard;
+	node = getNode(id);
 
-	if((sh_mem_adds.id = shmat(ctrl->shid_id,
-																			 NULL, 0)) == (void*) -1){
-		printf("Falha ao ler estrutura de estatísticas\n");
-		exit(1);
-	}
-	shmctl(ctrl->shid_id, IPC_RMID, (struct shmid_ds *) NULL);
+	node->next = shard->head;
+	shard->head = id;
+	shard->size++;
 
-	if(set_id){
-		(*sh_mem_adds.id) = 0;
+	if(shard->size >= 2 * SH_SHARD_BATCH){
+		moveNodes(&shard->head, &shard->size, &sh_mem_adds.ctrl_add->next_free_id,
+							&sh_mem_adds.ctrl_add->free_list_size, SH_SHARD_BATCH);
+		shard->spills++;
 	}
 }
 
-void getSem(sh_mem_t* ctrl){
-	if((sem = shmat(ctrl->sem_id, NULL, 0)) == (void*) -1){
-		printf("Falha ao ler estrutura de estatísticas\n");
-		exit(1);
-	}
-	shmctl(ctrl->sem_id, IPC_RMID, (struct shmid_ds *) NULL);
+void shPrintInfo(){
+	sh_mem_t* ctrl = sh_mem_adds.ctrl_add;
+	sh_shard_t total = { 0 };
+	int i;
+
+	for(i = 0; i < ctrl->n_shards; i++){
+		total.size += sh_mem_adds.shards[i].size;
+		total.allocs += sh_mem_adds.shards[i].allocs;
+		total.hits += sh_mem_adds.shards[i].hits;
+		total.refills += sh_mem_adds.shards[i].refills;
+		total.spills += sh_mem_adds.shards[i].spills;
+		total.steals += sh_mem_adds.shards[i].steals;
+	}
+
+	printf("Heap de nós: %d pedaço(s) de %d nós, %d nós usados, %d livres no pool e %d nas listas dos processos\n",
+				 ctrl->n_chunks, 1 << ctrl->chunk_shift,
+				 ((ctrl->n_chunks - 1) << ctrl->chunk_shift) + ctrl->mem_ptr, ctrl->free_list_size, total.size);
+	if(total.allocs > 0)
+		printf("Listas livres por processo: %.1lf%% das alocações na própria, %ld recargas do pool, %ld devoluções, %ld roubos\n",
+					 100.0 * total.hits / total.allocs, total.refills, total.spills, total.steals);
 }
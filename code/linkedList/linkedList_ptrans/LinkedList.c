@@ -13,6 +13,9 @@
 #include <fcntl.h>
 #include <sys/wait.h>
 #include "SharedMemoryController.h"
+#include "Workload.h"
+#include "Timer.h"
+#include "Placement.h"
 
 #define TRUE 1
 #define FALSE 0
@@ -23,7 +26,6 @@ typedef struct pthread_arg{
   int out;
 }pthread_arg;
 
-int mem_ctrl_id;
 LLNode* sentinela;
 stats_t* stats;
 sh_mem_add_t sh_mem_adds;
@@ -33,12 +35,17 @@ static int datasetsize = 256;         // number of items
 static double duration = 5.0f;        // in seconds
 static int doWarmup = FALSE;
 static int verbose = FALSE;
+static char* tracePath = NULL;                 // trace binário para replay (-r)
+static int sampleMs = 0;                       // intervalo da série de vazão (-I)
+static char* seriesPath = NULL;                // arquivo CSV da série (-o)
 static int num_ops = 0;               // number of operations mode value.
 static int n_threads = 2;
+static int arenaFlags = 0;            // páginas grandes e prefault da memória compartilhada (-H, -P)
 
 // these three are for getting various lookup/insert/remove ratios
 static float lookupPct = 0.34f;
 static float insertPct = 0.67f;
+static float insertFrac = -1.0f;               // -1: metade do que sobra dos lookups
 
 // Controla o tempo de execução
 struct timespec tstart, tend;
@@ -66,6 +73,16 @@ void help(int msg){
   printf("\n\tt : Tempo de duração da execução (segundos) [5.0]");
   printf("\n\tw : Ativa o Warm Up antes da execução [FALSE]");
   printf("\n\tx : Muda para o modo de execução por número de operações.");
+  printf("\n\tl : Fração de lookups [0.34]");
+  printf("\n\ti : Fração de inserts, o resto são removes [metade do que sobra dos lookups]");
+  printf("\n\tk : Distribuição das chaves: uniform, zipf[:theta], hotspot[:chaves[:ops]] ou seq [uniform]");
+  printf("\n\tr : Reproduz as operações de um trace gerado pelo tracegen");
+  printf("\n\tI : Amostra a vazão de cada thread a cada I ms [desativado]");
+  printf("\n\to : Grava a série de vazão em um arquivo CSV em vez da saída padrão");
+  printf("\n\ta : Afinidade: compact, scatter ou list:0,2,4-7 [nenhuma]");
+  printf("\n\tN : Política de memória NUMA: local ou interleave [padrão do sistema]");
+  printf("\n\tH : Páginas grandes na memória compartilhada: hugetlbfs, ou THP se não houver páginas reservadas");
+  printf("\n\tP : Toca todas as páginas da memória compartilhada antes da execução");
   printf("\n\tv : Ativa o modo verbose.");
   printf("\n\th : Mostra essa mensagem\n\n");
 	exit(1);
@@ -82,10 +99,20 @@ void getArgs(int argc, char *argv[]){
     {"time", 1, NULL, 't'},
     {"warmup", 0, NULL, 'w'},
     {"verbose", 0, NULL, 'v'},
+    {"replay", 1, NULL, 'r'},
+    {"lookup", 1, NULL, 'l'},
+    {"insert", 1, NULL, 'i'},
+    {"keys", 1, NULL, 'k'},
+    {"interval", 1, NULL, 'I'},
+    {"series", 1, NULL, 'o'},
+    {"affinity", 1, NULL, 'a'},
+    {"numa", 1, NULL, 'N'},
+    {"hugepages", 0, NULL, 'H'},
+    {"prefault", 0, NULL, 'P'},
     {"x", 1, NULL, 'x'}
 	};
 
-	while ((op = getopt_long(argc, argv, "n:s:t:wvx:h", longopts, NULL)) != -1) {
+	while ((op = getopt_long(argc, argv, "n:s:t:wvx:l:i:k:r:I:o:a:N:HPh", longopts, NULL)) != -1) {
 		switch (op) {
       case 'n':
         n_threads = atoi(optarg);
@@ -111,6 +138,46 @@ void getArgs(int argc, char *argv[]){
         num_ops = atoi(optarg);
         break;
 
+      case 'l':
+        lookupPct = atof(optarg);
+        break;
+
+      case 'i':
+        insertFrac = atof(optarg);
+        break;
+
+      case 'k':
+        workloadDist(optarg);
+        break;
+
+      case 'I':
+        sampleMs = atoi(optarg);
+        break;
+
+      case 'o':
+        seriesPath = optarg;
+        break;
+
+      case 'a':
+        placementAffinity(optarg);
+        break;
+
+      case 'N':
+        placementNuma(optarg);
+        break;
+
+      case 'H':
+        arenaFlags |= ARENA_HUGEPAGES;
+        break;
+
+      case 'P':
+        arenaFlags |= ARENA_PREFAULT;
+        break;
+
+      case 'r':
+        tracePath = optarg;
+        break;
+
       case 'h':
         help(0);
         break;
@@ -120,6 +187,11 @@ void getArgs(int argc, char *argv[]){
         break;
       }
     }
+
+  // a fração de removes é o que sobra
+  if(insertFrac < 0)
+    insertFrac = (1.0f - lookupPct) / 2;
+  insertPct = lookupPct + insertFrac;
 }
 
 /* Sanity Check */
@@ -273,23 +345,24 @@ void printLista(){
 
 void* experiment(void* arg, int tid){
   int result, val, i, done;
-  float action;
+  int op;
+  workload_t w;
   int l_ops, l_lookups_true, l_lookups_false, l_inserts, l_removes;
   l_ops = l_lookups_true = l_lookups_false = l_inserts = l_removes = 0;
 
   pthread_arg* p;
   p = malloc(sizeof(pthread_arg));
 
-  srand(time(NULL) + tid);
+  placementPin(tid);
+  workloadThread(&w, tid);
 
   //printf("\nAction = %f | val = %d\n", action, val);
 
   if(num_ops != 0){
     for(i = 0; i < num_ops / n_threads; i++){
-      action = (rand()%100) / 100.0;
-      val = rand() % datasetsize;
+      op = workloadNext(&w, &val);
 
-      if (action < lookupPct) {
+      if (op == OP_LOOKUP) {
         p->in = val;
         lookup(p);
         result = p->out;
@@ -301,7 +374,7 @@ void* experiment(void* arg, int tid){
 
         if(verbose) printf("%d -> lookup %d : %d\n", tid, val, result);
       }
-      else if (action < insertPct) {
+      else if (op == OP_INSERT) {
         if(verbose) printf("%d -> insert %d\n", tid, val);
         insert(val, &done);
         if(done)
@@ -315,14 +388,14 @@ void* experiment(void* arg, int tid){
 
       //int sane = isSane();
       l_ops++;
+      timerCount(tid, l_ops);
     }
     // Time duration mode
   } else {
     //printf("%d Entrou time duration mode\n",tid);
-    while(timeDiff < duration){
-      action = (rand()%100) / 100.0;
-      val = rand() % datasetsize;
-      if (action < lookupPct) {
+    while(timerRunning()){
+      op = workloadNext(&w, &val);
+      if (op == OP_LOOKUP) {
         p->in = val;
         lookup(p);
         result = p->out;
@@ -334,7 +407,7 @@ void* experiment(void* arg, int tid){
 
         if(verbose) printf("%d -> lookup %d : %d\n", tid, val, result);
       }
-      else if (action < insertPct) {
+      else if (op == OP_INSERT) {
         if(verbose) printf("%d -> insert %d\n", tid, val);
         insert(val, &done);
         if(done)
@@ -347,9 +420,7 @@ void* experiment(void* arg, int tid){
       }
 
       l_ops++;
-
-      clock_gettime(CLOCK_MONOTONIC, &tend);
-      timeDiff = ((double)tend.tv_sec + 1.0e-9*tend.tv_nsec) - ((double)tstart.tv_sec + 1.0e-9*tstart.tv_nsec);
+      timerCount(tid, l_ops);
     }
   }
 
@@ -385,6 +456,26 @@ void checkData(){
     printf("Modo Número de operações: Valor inválido. Abortando...\n");
     exit(1);
   }
+
+  if(lookupPct < 0 || lookupPct > 1){
+    printf("Fração de lookups inválida. Abortando...\n");
+    exit(1);
+  }
+
+  if(insertFrac < 0 || insertPct > 1.0001f){
+    printf("Fração de inserts inválida. Abortando...\n");
+    exit(1);
+  }
+
+  if(sampleMs < 0){
+    printf("Intervalo de amostragem inválido. Abortando...\n");
+    exit(1);
+  }
+
+  if(tracePath != NULL && n_threads > (int) workload.trace->n_threads){
+    printf("O trace só tem operações para %u threads. Abortando...\n", workload.trace->n_threads);
+    exit(1);
+  }
 }
 
 void printNode(LLNode* node){
@@ -405,6 +496,8 @@ void printInfo(){
   printf("\nTamanho máximo da lista = %d nodes", datasetsize);
   printf("\nPorcentagens das operações: %.2f Lookup / %.2f Insert / %.2f Remove",
             lookupPct, insertPct - lookupPct, 1.0f - insertPct);
+  workloadPrintInfo();
+  placementPrintInfo(n_threads);
 
   if(doWarmup)
     printf("\nWarm Up: ativado");
@@ -417,6 +510,8 @@ int main(int argc, char *argv[]) {
   printf("\nLinked List - Versão Processos + Transações\n");
 
 	getArgs(argc, argv);
+  placementInit();
+  workloadInit(tracePath, &datasetsize, &lookupPct, &insertPct);
 	checkData();
   printInfo();
 
@@ -426,15 +521,14 @@ int main(int argc, char *argv[]) {
   pthread_t threads[n_threads];
   void* pth_status;
 
+  timerInit(n_threads, num_ops != 0 ? 0 : duration, sampleMs, seriesPath);
   clock_gettime(CLOCK_MONOTONIC, &tstart);
   timeDiff = 0;
 
   /* SHM */
   printf("\n\n\t--- Rodando experimentos ---\n");
 
-  sh_mem_adds.ctrl_add = createShMem(1000); //1000 é o número de nós máximo
-
-  getMemAdds(0, 1);
+  createShMem(datasetsize, n_threads, arenaFlags); //pedaços de datasetsize nós, mais são criados quando acabam
   stats = sh_mem_adds.stats_add;
 
   sentinela = shAlloc(&id);
@@ -467,27 +561,23 @@ int main(int argc, char *argv[]) {
 
   if(pid == 0){
     //A partir daqui todos o processos executam isso
-    sh_mem_adds.ctrl_add = NULL;
-    sh_mem_adds.free_list_add = NULL;
-    sh_mem_adds.node_mem_add = NULL;
-    sh_mem_adds.stats_add = NULL;
-
-    getMemAdds(1, 0);
-
-    stats = sh_mem_adds.stats_add;
-
+    //A arena foi mapeada antes do fork: sentinela e stats já valem aqui
     //printf("%d %d\n", getpid(), sh_mem_adds.node_mem_add);
     //printNode(sentinela);
 
-    experiment(NULL, getpid());
+    shRegister(i);
+    experiment(NULL, i);
 
   } else {
+    // o timer roda no pai, os filhos só leem a flag compartilhada
+    timerStart();
     if(verbose) printf("Pai esperando\n");
 
     for(i = 0; i < n_threads; i++){
       waitpid(-1, NULL, 0);
     }
 
+    timerStop();
     if(verbose) printf("Pai terminou\n");
   }
   //FORK "join"
@@ -512,6 +602,9 @@ int main(int argc, char *argv[]) {
   printf("Total de lookups falhados: %d\n", stats->lookups_false);
   printf("Total de Inserts: %d\n", stats->inserts);
   printf("Total de removes: %d\n", stats->removes);
+  arenaPrintInfo();
+  shPrintInfo();
+  timerPrintSeries();
 
   return 0;
 }
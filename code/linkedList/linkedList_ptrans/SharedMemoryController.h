@@ -3,9 +3,9 @@
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <sys/shm.h>
 #include <semaphore.h>
 #include <sys/types.h>
+#include "ShArena.h"
 
 #define SNAME "/mysem21"
 
@@ -23,35 +23,61 @@ typedef struct stats_t{
   int removes;
 } stats_t;
 
-typedef struct free_id_t{
-  int id;
-  int previous;
-} free_id_t;
-
+/* Os nós ficam em pedaços de 2^chunk_shift nós, criados sob demanda; o id
+   de um nó é (pedaço << chunk_shift) | posição no pedaço */
+#define SH_MAX_CHUNKS 1024
+#define SH_MIN_CHUNK_SHIFT 10
+
+/* Cada processo tem a própria lista livre; ela troca lotes com a lista
+   global (o pool) quando esvazia ou passa de 2 lotes */
+#define SH_SHARD_BATCH 32
+
+/* Lista livre de um processo, ligada pelo next dos nós. Só o dono mexe
+   nela, fora os roubos de quem ficou sem nós */
+typedef struct sh_shard_t{
+  int head;
+  int size;
+  long allocs;
+  long hits;                    // alocações atendidas pela própria lista
+  long refills;                 // lotes trazidos do pool
+  long spills;                  // lotes devolvidos ao pool
+  long steals;                  // lotes tirados da lista de outro processo
+} __attribute__((aligned(CACHE_LINE))) sh_shard_t;
+
+/* Controle da memória de nós, na arena compartilhada */
 typedef struct sh_mem_t{
-  int n_nodes;
-  int node_mem_shmid;
-  int mem_ptr;
-  int free_list_shmid;
-  int free_list_size;
+  int chunk_shift;
+  int max_chunks;               // o id tem que caber num int
+  int n_chunks;                 // pedaços criados, só cresce
+  int mem_ptr;                  // próximo nó ainda não usado no último pedaço
+  int free_list_size;           // pool global, também ligado pelo next dos nós
   int next_free_id;
-  int stats_shmid;
-  int shid_id;
+  int n_shards;                 // um por processo filho, mais um do pai
+  size_t chunk_bytes;           // múltiplo da página da arena
+  size_t chunk_base;            // deslocamento no memfd do pedaço 1; o 0 vem com a arena
 } sh_mem_t;
 
+/* Endereços neste processo; o mapeamento da arena é herdado pelo fork, os
+   pedaços criados depois são mapeados por cada processo ao encontrá-los */
 typedef struct sh_mem_add_t{
   sh_mem_t* ctrl_add;
-  free_id_t* free_list_add;
-  LLNode* node_mem_add;
   stats_t* stats_add;
-  int* id;
+  sh_shard_t* shards;
+  sh_shard_t* shard;            // a lista livre deste processo
+  int chunk_shift;              // cópias locais de ctrl, para getNode não ler a memória compartilhada
+  int chunk_mask;
+  LLNode* chunks[SH_MAX_CHUNKS];
 } sh_mem_add_t;
 
 
-extern int mem_ctrl_id;
 extern sh_mem_add_t sh_mem_adds;
 
-sh_mem_t* createShMem(int n_nodes);
+/* Os pedaços têm n_nodes nós, arredondado para potência de 2; até a
+   chamada de shRegister o processo usa a lista livre n_procs */
+sh_mem_t* createShMem(int n_nodes, int n_procs, int arena_flags);
+
+/* Passa a usar a lista livre do processo tid; chamada pelo filho depois do fork */
+void shRegister(int tid);
 
 __attribute__((transaction_safe)) LLNode* shAlloc(int* id);
 
@@ -59,7 +85,7 @@ __attribute__((transaction_safe)) void shFree(int id);
 
 __attribute__((transaction_safe)) LLNode* getNode(int id);
 
-void getMemAdds(int ct, int set_id);
+void shPrintInfo();
 
 void printNode(LLNode* node);
 
@@ -6,6 +6,9 @@
 #include <stdlib.h>
 #include <getopt.h>
 #include <time.h>
+#include "Workload.h"
+#include "Timer.h"
+#include "Placement.h"
 
 #define TRUE 1
 #define FALSE 0
@@ -17,6 +20,7 @@ typedef struct exp_arg{
 }exp_arg;
 
 exp_arg* p;
+workload_t w;
 
 typedef struct LLNode {
     int val;
@@ -34,12 +38,16 @@ static int datasetsize = 256;                  // number of items
 static double duration = 5.0f;                 // in seconds
 static int doWarmup = FALSE;
 static int verbose = FALSE;
+static char* tracePath = NULL;                 // trace binário para replay (-r)
+static int sampleMs = 0;                       // intervalo da série de vazão (-I)
+static char* seriesPath = NULL;                // arquivo CSV da série (-o)
 static int num_ops = 0;                        // number of operations mode value.
 static int count_ops = 0;
 
 // these three are for getting various lookup/insert/remove ratios
 static float lookupPct = 0.34f;
 static float insertPct = 0.67f;
+static float insertFrac = -1.0f;               // -1: metade do que sobra dos lookups
 
 // Controla o tempo de execução
 struct timespec tstart, tend;
@@ -64,6 +72,14 @@ void help(int msg){
   printf("\n\tt : Tempo de duração da execução (segundos) [5.0]");
   printf("\n\tw : Ativa o Warm Up antes da execução [FALSE]");
   printf("\n\tx : Muda para o modo de execução por número de operações.");
+  printf("\n\tl : Fração de lookups [0.34]");
+  printf("\n\ti : Fração de inserts, o resto são removes [metade do que sobra dos lookups]");
+  printf("\n\tk : Distribuição das chaves: uniform, zipf[:theta], hotspot[:chaves[:ops]] ou seq [uniform]");
+  printf("\n\tr : Reproduz as operações de um trace gerado pelo tracegen");
+  printf("\n\tI : Amostra a vazão de cada thread a cada I ms [desativado]");
+  printf("\n\to : Grava a série de vazão em um arquivo CSV em vez da saída padrão");
+  printf("\n\ta : Afinidade: compact, scatter ou list:0,2,4-7 [nenhuma]");
+  printf("\n\tN : Política de memória NUMA: local ou interleave [padrão do sistema]");
   printf("\n\tv : Ativa o modo verbose.");
   printf("\n\th : Mostra essa mensagem\n\n");
 	exit(1);
@@ -79,10 +95,18 @@ void getArgs(int argc, char *argv[]){
     {"time", 1, NULL, 't'},
     {"warmup", 0, NULL, 'w'},
     {"verbose", 0, NULL, 'v'},
+    {"replay", 1, NULL, 'r'},
+    {"lookup", 1, NULL, 'l'},
+    {"insert", 1, NULL, 'i'},
+    {"keys", 1, NULL, 'k'},
+    {"interval", 1, NULL, 'I'},
+    {"series", 1, NULL, 'o'},
+    {"affinity", 1, NULL, 'a'},
+    {"numa", 1, NULL, 'N'},
     {"x", 1, NULL, 'x'}
 	};
 
-	while ((op = getopt_long(argc, argv, "s:t:wvx:h", longopts, NULL)) != -1) {
+	while ((op = getopt_long(argc, argv, "s:t:wvx:l:i:k:r:I:o:a:N:h", longopts, NULL)) != -1) {
 		switch (op) {
 			case 's':
 				datasetsize = atoi(optarg);
@@ -104,6 +128,38 @@ void getArgs(int argc, char *argv[]){
         num_ops = atoi(optarg);
         break;
 
+      case 'l':
+        lookupPct = atof(optarg);
+        break;
+
+      case 'i':
+        insertFrac = atof(optarg);
+        break;
+
+      case 'k':
+        workloadDist(optarg);
+        break;
+
+      case 'I':
+        sampleMs = atoi(optarg);
+        break;
+
+      case 'o':
+        seriesPath = optarg;
+        break;
+
+      case 'a':
+        placementAffinity(optarg);
+        break;
+
+      case 'N':
+        placementNuma(optarg);
+        break;
+
+      case 'r':
+        tracePath = optarg;
+        break;
+
       case 'h':
         help(0);
         break;
@@ -113,6 +169,11 @@ void getArgs(int argc, char *argv[]){
         break;
       }
     }
+
+  // a fração de removes é o que sobra
+  if(insertFrac < 0)
+    insertFrac = (1.0f - lookupPct) / 2;
+  insertPct = lookupPct + insertFrac;
 }
 
 /* Checa se os parametros são validos, aborta caso não sejam */
@@ -132,6 +193,21 @@ void checkData(){
     exit(1);
   }
 
+  if(lookupPct < 0 || lookupPct > 1){
+    printf("Fração de lookups inválida. Abortando...\n");
+    exit(1);
+  }
+
+  if(insertFrac < 0 || insertPct > 1.0001f){
+    printf("Fração de inserts inválida. Abortando...\n");
+    exit(1);
+  }
+
+  if(sampleMs < 0){
+    printf("Intervalo de amostragem inválido. Abortando...\n");
+    exit(1);
+  }
+
   //duration = duration * 1000;
 }
 
@@ -254,6 +330,8 @@ void printInfo(){
   printf("\nTamanho máximo da lista = %d nodes", datasetsize);
   printf("\nPorcentagens das operações: %.2f Lookup / %.2f Insert / %.2f Remove",
             lookupPct, insertPct - lookupPct, 1.0f - insertPct);
+  workloadPrintInfo();
+  placementPrintInfo(1);
 
   if(doWarmup)
     printf("\nWarm Up: ativado");
@@ -265,12 +343,12 @@ void experiment(){
     //int tid = (int*) arg;
     int result;
 
-    float action = (rand()%100) / 100.0;
-    int val = rand()%datasetsize;
+    int val;
+    int op = workloadNext(&w, &val);
 
     //printf("\nAction = %f | val = %d\n", action, val);
 
-    if (action < lookupPct) {
+    if (op == OP_LOOKUP) {
       p->in = val;
       lookup(p);
       result = p->out;
@@ -282,7 +360,7 @@ void experiment(){
 
       if(verbose) printf("Lookup %d -> %d \n", val, result);
     }
-    else if (action < insertPct) {
+    else if (op == OP_INSERT) {
       if(verbose) printf("Insert: %d\n", val);
       insert(val);
       inserts++;
@@ -301,6 +379,8 @@ int main(int argc, char *argv[]) {
   printf("\nLinked List - versão sequencial\n");
 
 	getArgs(argc, argv);
+  placementInit();
+  workloadInit(tracePath, &datasetsize, &lookupPct, &insertPct);
 	checkData();
   printInfo();
 
@@ -319,9 +399,13 @@ int main(int argc, char *argv[]) {
       }
   }
 
-  srand (time(NULL));
+  workloadThread(&w, 0);
+  timerInit(1, num_ops != 0 ? 0 : duration, sampleMs, seriesPath);
   clock_gettime(CLOCK_MONOTONIC, &tstart);
   timeDiff = 0;
+  timerStart();
+  // depois do timer, que não deve herdar a CPU da thread principal
+  placementPin(0);
 
   printf("\n\n\t--- Rodando experimentos ---\n");
   // Num_ops mode
@@ -329,20 +413,23 @@ int main(int argc, char *argv[]) {
     for(i = 0; i < num_ops; i++){
       experiment();
       count_ops++;
+      timerCount(0, count_ops);
     }
     clock_gettime(CLOCK_MONOTONIC, &tend);
     timeDiff = ((double)tend.tv_sec + 1.0e-9*tend.tv_nsec) - ((double)tstart.tv_sec + 1.0e-9*tstart.tv_nsec);
 
   // Time duration mode
   } else {
-    while(timeDiff < duration){
+    while(timerRunning()){
       experiment();
-      clock_gettime(CLOCK_MONOTONIC, &tend);
-      timeDiff = ((double)tend.tv_sec + 1.0e-9*tend.tv_nsec) - ((double)tstart.tv_sec + 1.0e-9*tstart.tv_nsec);
       count_ops++;
+      timerCount(0, count_ops);
     }
+    clock_gettime(CLOCK_MONOTONIC, &tend);
+    timeDiff = ((double)tend.tv_sec + 1.0e-9*tend.tv_nsec) - ((double)tstart.tv_sec + 1.0e-9*tstart.tv_nsec);
   }
 
+  timerStop();
   printf("\t    FIM DA EXECUÇÃO.\n");
 
   if(verbose) printLista();
@@ -358,6 +445,7 @@ int main(int argc, char *argv[]) {
   printf("Total de lookups falhados: %d\n", lookups_false);
   printf("Total de Inserts: %d\n", inserts);
   printf("Total de removes: %d\n", removes);
+  timerPrintSeries();
 
   return 0;
 }
@@ -0,0 +1,695 @@
+/* Implementação do benchmark LinkedList da RSTM em C */
+/* Autor: Bruno Cesar, @bcesarg6, bcesar.g6@gmail.com */
+/* Abril de 2018                                      */
+/* Versão skip list (lazy, lookup sem locks)          */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+#include <time.h>
+#include <pthread.h>
+#include "EBR.h"
+#include "Workload.h"
+#include "Timer.h"
+#include "Placement.h"
+
+#define TRUE 1
+#define FALSE 0
+
+#define LOAD(addr) __atomic_load_n((addr), __ATOMIC_ACQUIRE)
+#define STORE(addr, v) __atomic_store_n((addr), (v), __ATOMIC_RELEASE)
+
+/* 2^24 nós cabem com p = 1/2 por nível */
+#define MAX_LEVEL 24
+
+/* Protege apenas o id das threads e as estatísticas, a lista usa os locks dos nós */
+pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* Estruturas */
+typedef struct pthread_arg{
+  int in;
+  int out;
+}pthread_arg;
+
+typedef struct LLNode {
+    int val;
+    int topLevel;               // índice do nível mais alto em que o nó aparece
+    int marked;                 // TRUE quando o nó foi removido logicamente
+    int fullyLinked;            // TRUE quando o nó já está ligado em todos os níveis
+    pthread_mutex_t lock;
+    struct LLNode *next[];      // topLevel + 1 ponteiros, next[0] é a lista completa
+} LLNode;
+
+LLNode* sentinela;
+static __thread unsigned int level_seed = 2463534242u;
+static int lookups_true = 0;
+static int lookups_false = 0;
+static int inserts = 0;
+static int removes = 0;
+
+/* Dados globais com valores padrão */
+static int datasetsize = 256;                  // number of items
+static double duration = 5.0f;                 // in seconds
+static int doWarmup = FALSE;
+static int verbose = FALSE;
+static char* tracePath = NULL;                 // trace binário para replay (-r)
+static int sampleMs = 0;                       // intervalo da série de vazão (-I)
+static char* seriesPath = NULL;                // arquivo CSV da série (-o)
+static int num_ops = 0;                        // number of operations mode value.
+static int count_ops = 0;
+static int n_threads = 2;
+
+// these three are for getting various lookup/insert/remove ratios
+static float lookupPct = 0.34f;
+static float insertPct = 0.67f;
+static float insertFrac = -1.0f;               // -1: metade do que sobra dos lookups
+
+// Controla o tempo de execução
+struct timespec tstart, tend;
+double timeDiff;
+
+int gtid = 0;
+
+/* Exibe ajuda e finaliza o programa */
+void help(int msg){
+  switch (msg) {
+    case 1:
+      printf("\nNúmero insuficiente de parametros!\n");
+      break;
+
+    case 2:
+      printf("\nParametros de entrada inválidos!\n");
+      break;
+
+    default:
+      break;
+  }
+
+  printf("\n\tn : Número de threads [2]");
+	printf("\n\ts : Tamanho do datasetsize [256]");
+  printf("\n\tt : Tempo de duração da execução (segundos) [5.0]");
+  printf("\n\tw : Ativa o Warm Up antes da execução [FALSE]");
+  printf("\n\tx : Muda para o modo de execução por número de operações.");
+  printf("\n\tl : Fração de lookups [0.34]");
+  printf("\n\ti : Fração de inserts, o resto são removes [metade do que sobra dos lookups]");
+  printf("\n\tk : Distribuição das chaves: uniform, zipf[:theta], hotspot[:chaves[:ops]] ou seq [uniform]");
+  printf("\n\tr : Reproduz as operações de um trace gerado pelo tracegen");
+  printf("\n\tI : Amostra a vazão de cada thread a cada I ms [desativado]");
+  printf("\n\to : Grava a série de vazão em um arquivo CSV em vez da saída padrão");
+  printf("\n\ta : Afinidade: compact, scatter ou list:0,2,4-7 [nenhuma]");
+  printf("\n\tN : Política de memória NUMA: local ou interleave [padrão do sistema]");
+  printf("\n\tv : Ativa o modo verbose.");
+  printf("\n\th : Mostra essa mensagem\n\n");
+	exit(1);
+}
+
+/* Pega argumentos com getopt */
+void getArgs(int argc, char *argv[]){
+	extern char *optarg;
+	char op;
+
+	struct option longopts[] = {
+    {"n_threads", 1, NULL, 'n'},
+    {"size", 1, NULL, 's'},
+    {"time", 1, NULL, 't'},
+    {"warmup", 0, NULL, 'w'},
+    {"verbose", 0, NULL, 'v'},
+    {"replay", 1, NULL, 'r'},
+    {"lookup", 1, NULL, 'l'},
+    {"insert", 1, NULL, 'i'},
+    {"keys", 1, NULL, 'k'},
+    {"interval", 1, NULL, 'I'},
+    {"series", 1, NULL, 'o'},
+    {"affinity", 1, NULL, 'a'},
+    {"numa", 1, NULL, 'N'},
+    {"x", 1, NULL, 'x'}
+	};
+
+	while ((op = getopt_long(argc, argv, "n:s:t:wvx:l:i:k:r:I:o:a:N:h", longopts, NULL)) != -1) {
+		switch (op) {
+      case 'n':
+        n_threads = atoi(optarg);
+        break;
+
+			case 's':
+				datasetsize = atoi(optarg);
+				break;
+
+      case 't':
+        duration = atof(optarg);
+        break;
+
+      case 'w':
+        doWarmup = TRUE;
+        break;
+
+      case 'v':
+        verbose = TRUE;
+        break;
+
+      case 'x':
+        num_ops = atoi(optarg);
+        break;
+
+      case 'l':
+        lookupPct = atof(optarg);
+        break;
+
+      case 'i':
+        insertFrac = atof(optarg);
+        break;
+
+      case 'k':
+        workloadDist(optarg);
+        break;
+
+      case 'I':
+        sampleMs = atoi(optarg);
+        break;
+
+      case 'o':
+        seriesPath = optarg;
+        break;
+
+      case 'a':
+        placementAffinity(optarg);
+        break;
+
+      case 'N':
+        placementNuma(optarg);
+        break;
+
+      case 'r':
+        tracePath = optarg;
+        break;
+
+      case 'h':
+        help(0);
+        break;
+
+			default:
+        help(2);
+        break;
+      }
+    }
+
+  // a fração de removes é o que sobra
+  if(insertFrac < 0)
+    insertFrac = (1.0f - lookupPct) / 2;
+  insertPct = lookupPct + insertFrac;
+}
+
+/* Aloca um nó com topLevel + 1 níveis */
+LLNode* newNode(int val, int topLevel){
+  LLNode* node = malloc(sizeof(LLNode) + sizeof(LLNode*) * (topLevel + 1));
+  node->val = val;
+  node->topLevel = topLevel;
+  node->marked = FALSE;
+  node->fullyLinked = FALSE;
+  pthread_mutex_init(&node->lock, NULL);
+  return node;
+}
+
+/* Nível aleatório com distribuição geométrica (p = 1/2), sem usar rand() */
+int randomLevel(){
+  int level = 0;
+
+  // xorshift32 por thread
+  level_seed ^= level_seed << 13;
+  level_seed ^= level_seed >> 17;
+  level_seed ^= level_seed << 5;
+
+  unsigned int bits = level_seed;
+  while ((bits & 1) && level < MAX_LEVEL - 1){
+    level++;
+    bits >>= 1;
+  }
+  return level;
+}
+
+/* Sanity Check */
+int isSane(){
+    int sane = TRUE;
+    int level;
+
+    for (level = 0; level < MAX_LEVEL && sane; level++){
+      LLNode* prev = sentinela;
+      LLNode* curr = prev->next[level];
+
+      while (curr != NULL) {
+          if ((prev->val) >= (curr->val) || curr->marked || curr->topLevel < level) {
+              printf("FAILED SANITY CHECK IN: %d < %d (nível %d)\n", prev->val, curr->val, level);
+              sane = FALSE;
+              break;
+          }
+          prev = curr;
+          curr = (curr->next[level]);
+      }
+    }
+    return sane;
+}
+
+// optimistic traversal without locks; fills preds/succs for every level and
+// returns the highest level where a node with val was found, or -1
+int search(int val, LLNode** preds, LLNode** succs){
+  int lFound = -1;
+  int level;
+  LLNode* prev = sentinela;
+
+  for (level = MAX_LEVEL - 1; level >= 0; level--){
+    LLNode* curr = LOAD(&prev->next[level]);
+
+    while (curr != NULL && curr->val < val){
+      prev = curr;
+      curr = LOAD(&prev->next[level]);
+    }
+
+    if (lFound == -1 && curr != NULL && curr->val == val)
+      lFound = level;
+
+    preds[level] = prev;
+    succs[level] = curr;
+  }
+
+  return lFound;
+}
+
+// unlock every distinct pred locked up to highestLocked; preds never increase
+// going up, so equal preds are always on consecutive levels
+void unlockPreds(LLNode** preds, int highestLocked){
+  int level;
+
+  for (level = 0; level <= highestLocked; level++){
+    if (level == 0 || preds[level] != preds[level - 1])
+      pthread_mutex_unlock(&preds[level]->lock);
+  }
+}
+
+// insert method; find the right place in the list, add val so that it is in
+// sorted order; if val is already in the list, exit without inserting
+void insert(int val){
+  LLNode* preds[MAX_LEVEL];
+  LLNode* succs[MAX_LEVEL];
+  int topLevel = randomLevel();
+  int level, lFound, highestLocked, valid;
+  LLNode *prev, *succ, *prevPred;
+
+  ebrEnter();
+  while (TRUE){
+    // traverse the list to find the insertion point
+    lFound = search(val, preds, succs);
+
+    if (lFound != -1){
+      LLNode* found = succs[lFound];
+
+      // already in the list: wait for a concurrent insert to finish linking
+      if (!LOAD(&found->marked)){
+        while (!LOAD(&found->fullyLinked))
+          ;
+        break;
+      }
+      // being removed: try again once it is unlinked
+      continue;
+    }
+
+    // lock and validate the preds from the bottom up
+    highestLocked = -1;
+    prevPred = NULL;
+    valid = TRUE;
+    for (level = 0; valid && level <= topLevel; level++){
+      prev = preds[level];
+      succ = succs[level];
+      if (prev != prevPred){
+        pthread_mutex_lock(&prev->lock);
+        highestLocked = level;
+        prevPred = prev;
+      }
+      valid = !LOAD(&prev->marked) && (succ == NULL || !LOAD(&succ->marked)) &&
+              prev->next[level] == succ;
+    }
+
+    if (!valid){
+      unlockPreds(preds, highestLocked);
+      continue;
+    }
+
+    // ESCRITA : REGIÃO CRITICA (preds travados)
+    LLNode* novo = newNode(val, topLevel);
+    for (level = 0; level <= topLevel; level++)
+      novo->next[level] = succs[level];
+    for (level = 0; level <= topLevel; level++)
+      STORE(&preds[level]->next[level], novo);
+
+    // linearization point: lookups only report fully linked nodes
+    STORE(&novo->fullyLinked, TRUE);
+    // FIM
+
+    unlockPreds(preds, highestLocked);
+    break;
+  }
+  ebrExit();
+}
+
+// search function; wait-free, takes no locks and never writes to the list
+void lookup(void* arg){
+  pthread_arg* p = (pthread_arg*) arg;
+  int val = p->in;
+  int level;
+
+  int found = FALSE;
+
+  ebrEnter();
+  LLNode* prev = sentinela;
+  LLNode* curr = NULL;
+
+  for (level = MAX_LEVEL - 1; level >= 0; level--){
+    curr = LOAD(&prev->next[level]);
+
+    while (curr != NULL && curr->val < val){
+      prev = curr;
+      curr = LOAD(&prev->next[level]);
+    }
+
+    if (curr != NULL && curr->val == val)
+      break;
+  }
+
+  found = ((curr != NULL) && (curr->val == val) &&
+           LOAD(&curr->fullyLinked) && !LOAD(&curr->marked));
+  ebrExit();
+
+  p->out = found;
+}
+
+// remove a node if its value == val
+void removeNode(int val){
+  LLNode* preds[MAX_LEVEL];
+  LLNode* succs[MAX_LEVEL];
+  LLNode* victim = NULL;
+  int isMarked = FALSE;
+  int topLevel = -1;
+  int level, lFound, highestLocked, valid;
+  LLNode *prev, *prevPred;
+
+  ebrEnter();
+  while (TRUE){
+    // find the node whose val matches the request
+    lFound = search(val, preds, succs);
+    if (lFound != -1)
+      victim = succs[lFound];
+
+    // only a fully linked node found at its top level can be removed; if it
+    // is already marked by someone else, the search failed
+    if (!isMarked && (lFound == -1 || !LOAD(&victim->fullyLinked) ||
+                      victim->topLevel != lFound || LOAD(&victim->marked)))
+      break;
+
+    if (!isMarked){
+      topLevel = victim->topLevel;
+      pthread_mutex_lock(&victim->lock);
+      if (victim->marked){
+        pthread_mutex_unlock(&victim->lock);
+        break;
+      }
+      // logical deletion first, so lookups stop reporting it
+      STORE(&victim->marked, TRUE);
+      isMarked = TRUE;
+    }
+
+    highestLocked = -1;
+    prevPred = NULL;
+    valid = TRUE;
+    for (level = 0; valid && level <= topLevel; level++){
+      prev = preds[level];
+      if (prev != prevPred){
+        pthread_mutex_lock(&prev->lock);
+        highestLocked = level;
+        prevPred = prev;
+      }
+      valid = !LOAD(&prev->marked) && prev->next[level] == victim;
+    }
+
+    if (!valid){
+      unlockPreds(preds, highestLocked);
+      continue;
+    }
+
+    // ESCRITA : REGIÃO CRITICA (preds e victim travados)
+    for (level = topLevel; level >= 0; level--)
+      STORE(&preds[level]->next[level], victim->next[level]);
+
+    pthread_mutex_unlock(&victim->lock);
+    unlockPreds(preds, highestLocked);
+
+    // lock-free readers may still be on victim: free it later
+    ebrRetire(victim);
+    // FIM
+    break;
+  }
+  ebrExit();
+}
+
+// print the list
+void printLista(){
+    LLNode* curr = sentinela;
+    curr = (curr->next[0]);
+
+    printf("lista :");
+    while (curr != NULL){
+        printf(" %d ->", curr->val);
+        curr = (curr->next[0]);
+    }
+
+    printf(" NULL\n\n");
+}
+
+void* experiment(void* arg){
+  /* Garante thread id unico para a threads */
+  pthread_mutex_lock(&mutex);
+  int tid = gtid++;
+  pthread_mutex_unlock(&mutex);
+  placementPin(tid);
+  level_seed = time(NULL) + tid + 1;
+  ebrRegister(tid);
+
+  //printf("tid = %d\n", tid);
+  int result, val, i;
+  int op;
+  workload_t w;
+  int l_ops, l_lookups_true, l_lookups_false, l_inserts, l_removes;
+  l_ops = l_lookups_true = l_lookups_false = l_inserts = l_removes = 0;
+
+  pthread_arg* p;
+  p = malloc(sizeof(pthread_arg));
+
+  workloadThread(&w, tid);
+
+  //printf("\nAction = %f | val = %d\n", action, val);
+
+  if(num_ops != 0){
+    for(i = 0; i < num_ops / n_threads; i++){
+      op = workloadNext(&w, &val);
+
+      if (op == OP_LOOKUP) {
+        p->in = val;
+        lookup(p);
+        result = p->out;
+
+        if (result)
+          l_lookups_true++;
+        else
+          l_lookups_false++;
+
+        if(verbose) printf("%d -> lookup %d : %d\n", tid, val, result);
+      }
+      else if (op == OP_INSERT) {
+        if(verbose) printf("%d -> insert %d\n", tid, val);
+        insert(val);
+        l_inserts++;
+      }
+      else {
+        if(verbose) printf("%d -> remove %d\n", tid, val);
+        removeNode(val);
+        l_removes++;
+      }
+
+      //int sane = isSane();
+      l_ops++;
+      timerCount(tid, l_ops);
+    }
+    // Time duration mode
+  } else {
+    //printf("%d Entrou time duration mode\n",tid);
+    while(timerRunning()){
+      op = workloadNext(&w, &val);
+      if (op == OP_LOOKUP) {
+        p->in = val;
+        lookup(p);
+        result = p->out;
+
+        if (result)
+          l_lookups_true++;
+        else
+          l_lookups_false++;
+
+        if(verbose) printf("%d -> lookup %d : %d\n", tid, val, result);
+      }
+      else if (op == OP_INSERT) {
+        if(verbose) printf("%d -> insert %d\n", tid, val);
+        insert(val);
+        l_inserts++;
+      }
+      else {
+        if(verbose) printf("%d -> remove %d\n", tid, val);
+        removeNode(val);
+        l_removes++;
+      }
+
+      //int sane = isSane();
+      l_ops++;
+      timerCount(tid, l_ops);
+    }
+  }
+
+  pthread_mutex_lock(&mutex);
+  count_ops += l_ops;
+  inserts += l_inserts;
+  lookups_true += l_lookups_true;
+  lookups_false += l_lookups_false;
+  removes += l_removes;
+  pthread_mutex_unlock(&mutex);
+}
+
+/* Checa se os parametros são validos, aborta caso não sejam */
+void checkData(){
+  if(n_threads < 1){
+    printf("Número inválido de threads. Abortando...\n");
+    exit(1);
+  }
+
+	if(datasetsize < 1){
+		printf("Tamanho da lista inválida. Abortando...\n");
+		exit(1);
+	}
+
+  if(duration <=0){
+    printf("Tempo de execução inválido. Abortando...\n");
+    exit(1);
+  }
+
+  if(num_ops < 0){
+    printf("Modo Número de operações: Valor inválido. Abortando...\n");
+    exit(1);
+  }
+
+  if(lookupPct < 0 || lookupPct > 1){
+    printf("Fração de lookups inválida. Abortando...\n");
+    exit(1);
+  }
+
+  if(insertFrac < 0 || insertPct > 1.0001f){
+    printf("Fração de inserts inválida. Abortando...\n");
+    exit(1);
+  }
+
+  if(sampleMs < 0){
+    printf("Intervalo de amostragem inválido. Abortando...\n");
+    exit(1);
+  }
+
+  if(tracePath != NULL && n_threads > (int) workload.trace->n_threads){
+    printf("O trace só tem operações para %u threads. Abortando...\n", workload.trace->n_threads);
+    exit(1);
+  }
+}
+
+void printInfo(){
+  printf("\nNúmero de threads = %d", n_threads);
+  if(num_ops != 0)
+    printf("\nModo número de operações = %d operações", num_ops);
+  else
+    printf("\nModo tempo de execução = %.2lf segundos", duration);
+  printf("\nTamanho máximo da fila = %d nodes", datasetsize);
+  printf("\nPorcentagens das operações: %.2f Lookup / %.2f Insert / %.2f Remove",
+            lookupPct, insertPct - lookupPct, 1.0f - insertPct);
+  workloadPrintInfo();
+  placementPrintInfo(n_threads);
+
+  if(doWarmup)
+    printf("\nWarm Up: ativado");
+  else
+    printf("\nWarm Up: desativado");
+}
+
+int main(int argc, char *argv[]) {
+  int i;
+  printf("\nLinked List - versão skip list\n");
+
+	getArgs(argc, argv);
+  placementInit();
+  workloadInit(tracePath, &datasetsize, &lookupPct, &insertPct);
+	checkData();
+  printInfo();
+
+  /* Inicializa a lista criando a sentinela */
+  sentinela = newNode(-1, MAX_LEVEL - 1);
+  for (i = 0; i < MAX_LEVEL; i++)
+    sentinela->next[i] = NULL;
+  sentinela->fullyLinked = TRUE;
+
+  // tamanho médio de um nó: com p = 1/2 são dois níveis em média
+  ebrInit(n_threads, sizeof(LLNode) + 2 * sizeof(LLNode*), free);
+
+  pthread_t threads[n_threads];
+  void* pth_status;
+
+  /* Warm Up */
+  // warmup inserts half of the elements in the datasetsize
+  if(doWarmup){
+      for (i = 0; i < datasetsize; i+=2) {
+        insert(i);
+      }
+  }
+
+  timerInit(n_threads, num_ops != 0 ? 0 : duration, sampleMs, seriesPath);
+  clock_gettime(CLOCK_MONOTONIC, &tstart);
+  timeDiff = 0;
+  timerStart();
+
+  printf("\n\n\t--- Rodando experimentos ---\n");
+  for(i = 0; i < n_threads; i++){
+		pthread_create(&threads[i], NULL, experiment, NULL);
+	}
+
+  //experiment(NULL);
+
+  for(i = 0; i < n_threads; i++){
+		 pthread_join(threads[i], &pth_status);
+	}
+
+  timerStop();
+  clock_gettime(CLOCK_MONOTONIC, &tend);
+  timeDiff = ((double)tend.tv_sec + 1.0e-9*tend.tv_nsec) - ((double)tstart.tv_sec + 1.0e-9*tstart.tv_nsec);
+
+  printf("\t    FIM DA EXECUÇÃO.\n");
+
+  if(verbose) printLista();
+  printf("\nSanity Check: ");
+  if(isSane())
+    printf("Passed\n");
+  else
+    printf("Failed! Isn't sane!\n");
+
+  printf("Tempo de execução dos experimentos = %lf segundos\n", timeDiff);
+  printf("Total de operações realizadas = %d\n",count_ops);
+  printf("Total de lookups acertados: %d\n", lookups_true);
+  printf("Total de lookups falhados: %d\n", lookups_false);
+  printf("Total de Inserts: %d\n", inserts);
+  printf("Total de removes: %d\n", removes);
+  timerPrintSeries();
+
+  ebrPrintStats();
+  ebrFlush();
+
+  return 0;
+}
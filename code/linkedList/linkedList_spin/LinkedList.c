@@ -7,6 +7,11 @@
 #include <getopt.h>
 #include <time.h>
 #include <pthread.h>
+#include "EBR.h"
+#include "NodePool.h"
+#include "Workload.h"
+#include "Timer.h"
+#include "Placement.h"
 
 #define TRUE 1
 #define FALSE 0
@@ -34,7 +39,12 @@ static int removes = 0;
 static int datasetsize = 256;                  // number of items
 static double duration = 5.0f;                 // in seconds
 static int doWarmup = FALSE;
+static int usePool = FALSE;                    // aloca nós do pool por thread
+static int useEbr = FALSE;                     // libera nós removidos via EBR
 static int verbose = FALSE;
+static char* tracePath = NULL;                 // trace binário para replay (-r)
+static int sampleMs = 0;                       // intervalo da série de vazão (-I)
+static char* seriesPath = NULL;                // arquivo CSV da série (-o)
 static int num_ops = 0;                        // number of operations mode value.
 static int count_ops = 0;
 static int n_threads = 2;
@@ -42,6 +52,7 @@ static int n_threads = 2;
 // these three are for getting various lookup/insert/remove ratios
 static float lookupPct = 0.34f;
 static float insertPct = 0.67f;
+static float insertFrac = -1.0f;               // -1: metade do que sobra dos lookups
 
 // Controla o tempo de execução
 struct timespec tstart, tend;
@@ -68,7 +79,17 @@ void help(int msg){
 	printf("\n\ts : Tamanho do datasetsize [256]");
   printf("\n\tt : Tempo de duração da execução (segundos) [5.0]");
   printf("\n\tw : Ativa o Warm Up antes da execução [FALSE]");
+  printf("\n\tp : Aloca os nós de um pool por thread em vez de malloc/free [FALSE]");
   printf("\n\tx : Muda para o modo de execução por número de operações.");
+  printf("\n\te : Libera os nós removidos com EBR em vez de free imediato [FALSE]");
+  printf("\n\tl : Fração de lookups [0.34]");
+  printf("\n\ti : Fração de inserts, o resto são removes [metade do que sobra dos lookups]");
+  printf("\n\tk : Distribuição das chaves: uniform, zipf[:theta], hotspot[:chaves[:ops]] ou seq [uniform]");
+  printf("\n\tr : Reproduz as operações de um trace gerado pelo tracegen");
+  printf("\n\tI : Amostra a vazão de cada thread a cada I ms [desativado]");
+  printf("\n\to : Grava a série de vazão em um arquivo CSV em vez da saída padrão");
+  printf("\n\ta : Afinidade: compact, scatter ou list:0,2,4-7 [nenhuma]");
+  printf("\n\tN : Política de memória NUMA: local ou interleave [padrão do sistema]");
   printf("\n\tv : Ativa o modo verbose.");
   printf("\n\th : Mostra essa mensagem\n\n");
 	exit(1);
@@ -84,11 +105,21 @@ void getArgs(int argc, char *argv[]){
     {"size", 1, NULL, 's'},
     {"time", 1, NULL, 't'},
     {"warmup", 0, NULL, 'w'},
+    {"pool", 0, NULL, 'p'},
+    {"ebr", 0, NULL, 'e'},
     {"verbose", 0, NULL, 'v'},
+    {"replay", 1, NULL, 'r'},
+    {"lookup", 1, NULL, 'l'},
+    {"insert", 1, NULL, 'i'},
+    {"keys", 1, NULL, 'k'},
+    {"interval", 1, NULL, 'I'},
+    {"series", 1, NULL, 'o'},
+    {"affinity", 1, NULL, 'a'},
+    {"numa", 1, NULL, 'N'},
     {"x", 1, NULL, 'x'}
 	};
 
-	while ((op = getopt_long(argc, argv, "n:s:t:wvx:h", longopts, NULL)) != -1) {
+	while ((op = getopt_long(argc, argv, "n:s:t:wpevx:l:i:k:r:I:o:a:N:h", longopts, NULL)) != -1) {
 		switch (op) {
       case 'n':
         n_threads = atoi(optarg);
@@ -106,6 +137,14 @@ void getArgs(int argc, char *argv[]){
         doWarmup = TRUE;
         break;
 
+      case 'p':
+        usePool = TRUE;
+        break;
+
+      case 'e':
+        useEbr = TRUE;
+        break;
+
       case 'v':
         verbose = TRUE;
         break;
@@ -114,6 +153,38 @@ void getArgs(int argc, char *argv[]){
         num_ops = atoi(optarg);
         break;
 
+      case 'l':
+        lookupPct = atof(optarg);
+        break;
+
+      case 'i':
+        insertFrac = atof(optarg);
+        break;
+
+      case 'k':
+        workloadDist(optarg);
+        break;
+
+      case 'I':
+        sampleMs = atoi(optarg);
+        break;
+
+      case 'o':
+        seriesPath = optarg;
+        break;
+
+      case 'a':
+        placementAffinity(optarg);
+        break;
+
+      case 'N':
+        placementNuma(optarg);
+        break;
+
+      case 'r':
+        tracePath = optarg;
+        break;
+
       case 'h':
         help(0);
         break;
@@ -123,6 +194,25 @@ void getArgs(int argc, char *argv[]){
         break;
       }
     }
+
+  // a fração de removes é o que sobra
+  if(insertFrac < 0)
+    insertFrac = (1.0f - lookupPct) / 2;
+  insertPct = lookupPct + insertFrac;
+}
+
+/* Alocação dos nós: malloc/free ou pool por thread (-p) */
+LLNode* newNode(){
+  if(usePool)
+    return poolAlloc();
+  return malloc(sizeof(LLNode));
+}
+
+void freeNode(void* node){
+  if(usePool)
+    poolFree(node);
+  else
+    free(node);
 }
 
 /* Sanity Check */
@@ -149,6 +239,7 @@ int isSane(){
 // insert method; find the right place in the list, add val so that it is in
 // sorted order; if val is already in the list, exit without inserting
 void insert(int val){
+  if(useEbr) ebrEnter();
   pthread_spin_lock(&spin);
   // traverse the list to find the insertion point
   LLNode* prev = sentinela;
@@ -167,7 +258,7 @@ void insert(int val){
     // ESCRITA : REGIÃO CRITICA
 
     LLNode* insert_point = prev;
-    LLNode* novo = malloc(sizeof(LLNode));
+    LLNode* novo = newNode();
     novo->val = val;
     novo->next = curr;
 
@@ -175,10 +266,12 @@ void insert(int val){
     // FIM
     }
     pthread_spin_unlock(&spin);
+    if(useEbr) ebrExit();
 }
 
 // search function
 void lookup(void* arg){
+  if(useEbr) ebrEnter();
   pthread_spin_lock(&spin);
   pthread_arg* p = (pthread_arg*) arg;
   int val = p->in;
@@ -199,10 +292,12 @@ void lookup(void* arg){
 
   p->out = found;
   pthread_spin_unlock(&spin);
+  if(useEbr) ebrExit();
 }
 
 // remove a node if its value == val
 void removeNode(int val){
+  if(useEbr) ebrEnter();
   pthread_spin_lock(&spin);
   // find the node whose val matches the request
   LLNode* prev = sentinela;
@@ -217,7 +312,10 @@ void removeNode(int val){
       mod_point->next = curr->next;
 
       // delete curr...
-      free(curr);
+      if(useEbr)
+        ebrRetire(curr);
+      else
+        freeNode(curr);
       // FIM
       break;
     }
@@ -229,6 +327,7 @@ void removeNode(int val){
     curr = prev->next;
   }
   pthread_spin_unlock(&spin);
+  if(useEbr) ebrExit();
 }
 
 // print the list
@@ -250,26 +349,29 @@ void* experiment(void* arg){
   pthread_spin_lock(&spin);
   int tid = gtid++;
   pthread_spin_unlock(&spin);
+  placementPin(tid);
+  if(usePool) poolRegister(tid);
+  if(useEbr) ebrRegister(tid);
 
   //printf("tid = %d\n", tid);
   int result, val, i;
-  float action;
+  int op;
+  workload_t w;
   int l_ops, l_lookups_true, l_lookups_false, l_inserts, l_removes;
   l_ops = l_lookups_true = l_lookups_false = l_inserts = l_removes = 0;
 
   pthread_arg* p;
   p = malloc(sizeof(pthread_arg));
 
-  srand(time(NULL) + tid);
+  workloadThread(&w, tid);
 
   //printf("\nAction = %f | val = %d\n", action, val);
 
   if(num_ops != 0){
     for(i = 0; i < num_ops / n_threads; i++){
-      action = (rand()%100) / 100.0;
-      val = rand() % datasetsize;
+      op = workloadNext(&w, &val);
 
-      if (action < lookupPct) {
+      if (op == OP_LOOKUP) {
         p->in = val;
         lookup(p);
         result = p->out;
@@ -281,7 +383,7 @@ void* experiment(void* arg){
 
         if(verbose) printf("%d -> lookup %d : %d\n", tid, val, result);
       }
-      else if (action < insertPct) {
+      else if (op == OP_INSERT) {
         if(verbose) printf("%d -> insert %d\n", tid, val);
         insert(val);
         l_inserts++;
@@ -294,14 +396,14 @@ void* experiment(void* arg){
 
       //int sane = isSane();
       l_ops++;
+      timerCount(tid, l_ops);
     }
     // Time duration mode
   } else {
     //printf("%d Entrou time duration mode\n",tid);
-    while(timeDiff < duration){
-      action = (rand()%100) / 100.0;
-      val = rand() % datasetsize;
-      if (action < lookupPct) {
+    while(timerRunning()){
+      op = workloadNext(&w, &val);
+      if (op == OP_LOOKUP) {
         p->in = val;
         lookup(p);
         result = p->out;
@@ -313,7 +415,7 @@ void* experiment(void* arg){
 
         if(verbose) printf("%d -> lookup %d : %d\n", tid, val, result);
       }
-      else if (action < insertPct) {
+      else if (op == OP_INSERT) {
         if(verbose) printf("%d -> insert %d\n", tid, val);
         insert(val);
         l_inserts++;
@@ -326,11 +428,7 @@ void* experiment(void* arg){
 
       //int sane = isSane();
       l_ops++;
-
-      if(tid == 0){
-        clock_gettime(CLOCK_MONOTONIC, &tend);
-        timeDiff = ((double)tend.tv_sec + 1.0e-9*tend.tv_nsec) - ((double)tstart.tv_sec + 1.0e-9*tstart.tv_nsec);
-      }
+      timerCount(tid, l_ops);
     }
   }
 
@@ -364,6 +462,26 @@ void checkData(){
     printf("Modo Número de operações: Valor inválido. Abortando...\n");
     exit(1);
   }
+
+  if(lookupPct < 0 || lookupPct > 1){
+    printf("Fração de lookups inválida. Abortando...\n");
+    exit(1);
+  }
+
+  if(insertFrac < 0 || insertPct > 1.0001f){
+    printf("Fração de inserts inválida. Abortando...\n");
+    exit(1);
+  }
+
+  if(sampleMs < 0){
+    printf("Intervalo de amostragem inválido. Abortando...\n");
+    exit(1);
+  }
+
+  if(tracePath != NULL && n_threads > (int) workload.trace->n_threads){
+    printf("O trace só tem operações para %u threads. Abortando...\n", workload.trace->n_threads);
+    exit(1);
+  }
 }
 
 void printInfo(){
@@ -375,11 +493,23 @@ void printInfo(){
   printf("\nTamanho máximo da lista = %d nodes", datasetsize);
   printf("\nPorcentagens das operações: %.2f Lookup / %.2f Insert / %.2f Remove",
             lookupPct, insertPct - lookupPct, 1.0f - insertPct);
+  workloadPrintInfo();
+  placementPrintInfo(n_threads);
 
   if(doWarmup)
     printf("\nWarm Up: ativado");
   else
     printf("\nWarm Up: desativado");
+
+  if(usePool)
+    printf("\nAlocação de nós: pool por thread");
+  else
+    printf("\nAlocação de nós: malloc/free");
+
+  if(useEbr)
+    printf("\nReclamação de memória: EBR");
+  else
+    printf("\nReclamação de memória: free imediato");
 }
 
 int main(int argc, char *argv[]) {
@@ -387,6 +517,8 @@ int main(int argc, char *argv[]) {
   printf("\nLinked List - versão spin\n");
 
 	getArgs(argc, argv);
+  placementInit();
+  workloadInit(tracePath, &datasetsize, &lookupPct, &insertPct);
 	checkData();
   printInfo();
 
@@ -397,6 +529,9 @@ int main(int argc, char *argv[]) {
 
   pthread_spin_init(&spin, 0);
 
+  if(usePool) poolInit(n_threads, sizeof(LLNode));
+  if(useEbr) ebrInit(n_threads, sizeof(LLNode), freeNode);
+
   pthread_t threads[n_threads];
   void* pth_status;
 
@@ -408,8 +543,10 @@ int main(int argc, char *argv[]) {
       }
   }
 
+  timerInit(n_threads, num_ops != 0 ? 0 : duration, sampleMs, seriesPath);
   clock_gettime(CLOCK_MONOTONIC, &tstart);
   timeDiff = 0;
+  timerStart();
 
   printf("\n\n\t--- Rodando experimentos ---\n");
   for(i = 0; i < n_threads; i++){
@@ -422,6 +559,7 @@ int main(int argc, char *argv[]) {
 		 pthread_join(threads[i], &pth_status);
 	}
 
+  timerStop();
   clock_gettime(CLOCK_MONOTONIC, &tend);
   timeDiff = ((double)tend.tv_sec + 1.0e-9*tend.tv_nsec) - ((double)tstart.tv_sec + 1.0e-9*tstart.tv_nsec);
 
@@ -440,6 +578,17 @@ int main(int argc, char *argv[]) {
   printf("Total de lookups falhados: %d\n", lookups_false);
   printf("Total de Inserts: %d\n", inserts);
   printf("Total de removes: %d\n", removes);
+  timerPrintSeries();
+
+  if(useEbr){
+    ebrPrintStats();
+    ebrFlush();
+  }
+
+  if(usePool){
+    poolPrintStats();
+    poolDestroy();
+  }
 
   return 0;
 }
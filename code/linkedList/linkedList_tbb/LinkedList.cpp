@@ -1,33 +1,52 @@
 /* Implementação do benchmark LinkedList da RSTM em C */
 /* Autor: Bruno Cesar, @bcesarg6, bcesar.g6@gmail.com */
 /* Abril de 2018                                      */
+/* Versão TBB: tbb::spin_rw_mutex na lista, contadores por thread em  */
+/* enumerable_thread_specific, nós do scalable_allocator e o número   */
+/* de threads controlado por uma task_arena                           */
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <getopt.h>
 #include <time.h>
-#include <pthread.h>
 #include "tbb/tbb.h"
-//using namespace tbb;
-
-//link
+#include "tbb/spin_rw_mutex.h"
+#include "tbb/enumerable_thread_specific.h"
+#include "tbb/scalable_allocator.h"
+#include "tbb/task_arena.h"
+#include "tbb/global_control.h"
+#include "Workload.h"
+#include "Timer.h"
+#include "Placement.h"
 
 #define TRUE 1
 #define FALSE 0
 
-pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+/* Lookups compartilham o lock, inserts e removes são exclusivos */
+tbb::spin_rw_mutex list_mutex;
 
 /* Estruturas */
-typedef struct pthread_arg{
-  int in;
-  int out;
-}pthread_arg;
-
 typedef struct LLNode {
     int val;
     struct LLNode *next;
 } LLNode;
 
+/* Contadores de uma thread da TBB; uma thread que roda mais de um tid
+   soma tudo no mesmo */
+typedef struct thread_stats_t{
+  int ops;
+  int lookups_true;
+  int lookups_false;
+  int inserts;
+  int removes;
+  int experiments;              // tids rodados por essa thread
+} thread_stats_t;
+
+static const thread_stats_t zero_stats = {0, 0, 0, 0, 0, 0};
+tbb::enumerable_thread_specific<thread_stats_t> thread_stats(zero_stats);
+
+tbb::scalable_allocator<LLNode> node_allocator;
+
 LLNode* sentinela;
 static int lookups_true = 0;
 static int lookups_false = 0;
@@ -39,6 +58,9 @@ static int datasetsize = 256;                  // number of items
 static double duration = 5.0f;                 // in seconds
 static int doWarmup = FALSE;
 static int verbose = FALSE;
+static char* tracePath = NULL;                 // trace binário para replay (-r)
+static int sampleMs = 0;                       // intervalo da série de vazão (-I)
+static char* seriesPath = NULL;                // arquivo CSV da série (-o)
 static int num_ops = 0;                        // number of operations mode value.
 static int count_ops = 0;
 static int n_threads = 2;
@@ -46,6 +68,7 @@ static int n_threads = 2;
 // these three are for getting various lookup/insert/remove ratios
 static float lookupPct = 0.34f;
 static float insertPct = 0.67f;
+static float insertFrac = -1.0f;               // -1: metade do que sobra dos lookups
 
 // Controla o tempo de execução
 struct timespec tstart, tend;
@@ -73,6 +96,14 @@ void help(int msg){
   printf("\n\tt : Tempo de duração da execução (segundos) [5.0]");
   printf("\n\tw : Ativa o Warm Up antes da execução [FALSE]");
   printf("\n\tx : Muda para o modo de execução por número de operações.");
+  printf("\n\tl : Fração de lookups [0.34]");
+  printf("\n\ti : Fração de inserts, o resto são removes [metade do que sobra dos lookups]");
+  printf("\n\tk : Distribuição das chaves: uniform, zipf[:theta], hotspot[:chaves[:ops]] ou seq [uniform]");
+  printf("\n\tr : Reproduz as operações de um trace gerado pelo tracegen");
+  printf("\n\tI : Amostra a vazão de cada thread a cada I ms [desativado]");
+  printf("\n\to : Grava a série de vazão em um arquivo CSV em vez da saída padrão");
+  printf("\n\ta : Afinidade: compact, scatter ou list:0,2,4-7 [nenhuma]");
+  printf("\n\tN : Política de memória NUMA: local ou interleave [padrão do sistema]");
   printf("\n\tv : Ativa o modo verbose.");
   printf("\n\th : Mostra essa mensagem\n\n");
 	exit(1);
@@ -89,10 +120,18 @@ void getArgs(int argc, char *argv[]){
     {"time", 1, NULL, 't'},
     {"warmup", 0, NULL, 'w'},
     {"verbose", 0, NULL, 'v'},
+    {"replay", 1, NULL, 'r'},
+    {"lookup", 1, NULL, 'l'},
+    {"insert", 1, NULL, 'i'},
+    {"keys", 1, NULL, 'k'},
+    {"interval", 1, NULL, 'I'},
+    {"series", 1, NULL, 'o'},
+    {"affinity", 1, NULL, 'a'},
+    {"numa", 1, NULL, 'N'},
     {"x", 1, NULL, 'x'}
 	};
 
-	while ((op = getopt_long(argc, argv, "n:s:t:wvx:h", longopts, NULL)) != -1) {
+	while ((op = getopt_long(argc, argv, "n:s:t:wvx:l:i:k:r:I:o:a:N:h", longopts, NULL)) != -1) {
 		switch (op) {
       case 'n':
         n_threads = atoi(optarg);
@@ -118,6 +157,38 @@ void getArgs(int argc, char *argv[]){
         num_ops = atoi(optarg);
         break;
 
+      case 'l':
+        lookupPct = atof(optarg);
+        break;
+
+      case 'i':
+        insertFrac = atof(optarg);
+        break;
+
+      case 'k':
+        workloadDist(optarg);
+        break;
+
+      case 'I':
+        sampleMs = atoi(optarg);
+        break;
+
+      case 'o':
+        seriesPath = optarg;
+        break;
+
+      case 'a':
+        placementAffinity(optarg);
+        break;
+
+      case 'N':
+        placementNuma(optarg);
+        break;
+
+      case 'r':
+        tracePath = optarg;
+        break;
+
       case 'h':
         help(0);
         break;
@@ -127,12 +198,17 @@ void getArgs(int argc, char *argv[]){
         break;
       }
     }
+
+  // a fração de removes é o que sobra
+  if(insertFrac < 0)
+    insertFrac = (1.0f - lookupPct) / 2;
+  insertPct = lookupPct + insertFrac;
 }
 
 /* Sanity Check */
 int isSane(){
     int sane = TRUE;
-    pthread_mutex_lock(&mutex);
+    tbb::spin_rw_mutex::scoped_lock lock(list_mutex, false);
     LLNode* prev = sentinela;
     LLNode* curr = prev->next;
 
@@ -145,7 +221,6 @@ int isSane(){
         prev = curr;
         curr = (curr->next);
     }
-    pthread_mutex_unlock(&mutex);
     return sane;
 }
 
@@ -153,7 +228,7 @@ int isSane(){
 // insert method; find the right place in the list, add val so that it is in
 // sorted order; if val is already in the list, exit without inserting
 void insert(int val){
-  pthread_mutex_lock(&mutex);
+  tbb::spin_rw_mutex::scoped_lock lock(list_mutex, true);
   // traverse the list to find the insertion point
   LLNode* prev = sentinela;
   LLNode* curr = sentinela->next;
@@ -171,22 +246,18 @@ void insert(int val){
     // ESCRITA : REGIÃO CRITICA
 
     LLNode* insert_point = prev;
-    LLNode* novo = (LLNode*) malloc(sizeof(LLNode));
+    LLNode* novo = node_allocator.allocate(1);
     novo->val = val;
     novo->next = curr;
 
     insert_point->next = novo;
     // FIM
     }
-    pthread_mutex_unlock(&mutex);
 }
 
 // search function
-void lookup(void* arg){
-  pthread_mutex_lock(&mutex);
-  pthread_arg* p = (pthread_arg*) arg;
-  int val = p->in;
-
+int lookup(int val){
+  tbb::spin_rw_mutex::scoped_lock lock(list_mutex, false);
   int found = FALSE;
 
   LLNode* curr = sentinela;
@@ -201,13 +272,12 @@ void lookup(void* arg){
 
   found = ((curr != NULL) && (curr->val == val));
 
-  p->out = found;
-  pthread_mutex_unlock(&mutex);
+  return found;
 }
 
 // remove a node if its value == val
 void removeNode(int val){
-  pthread_mutex_lock(&mutex);
+  tbb::spin_rw_mutex::scoped_lock lock(list_mutex, true);
   // find the node whose val matches the request
   LLNode* prev = sentinela;
   LLNode* curr = prev->next;
@@ -221,7 +291,7 @@ void removeNode(int val){
       mod_point->next = curr->next;
 
       // delete curr...
-      free(curr);
+      node_allocator.deallocate(curr, 1);
       // FIM
       break;
     }
@@ -232,7 +302,6 @@ void removeNode(int val){
     prev = curr;
     curr = prev->next;
   }
-  pthread_mutex_unlock(&mutex);
 }
 
 // print the list
@@ -249,96 +318,47 @@ void printLista(){
     printf(" NULL\n\n");
 }
 
-void* experiment(int tid){
+void experiment(int tid){
   int result, val, i;
-  float action;
-  int l_ops, l_lookups_true, l_lookups_false, l_inserts, l_removes;
-  l_ops = l_lookups_true = l_lookups_false = l_inserts = l_removes = 0;
-
-  pthread_arg* p;
-  p = (pthread_arg*) malloc(sizeof(pthread_arg));
+  int op;
+  workload_t w;
+  int l_ops = 0;
+  thread_stats_t& st = thread_stats.local();
 
-  srand(time(NULL) + tid);
+  placementPin(tid);
+  workloadThread(&w, tid);
+  st.experiments++;
 
-  //printf("\nAction = %f | val = %d\n", action, val);
+  // number of operations mode runs until i reaches the share of this tid,
+  // time duration mode until the timer stops
+  for(i = 0; num_ops != 0 ? i < num_ops / n_threads : timerRunning(); i++){
+    op = workloadNext(&w, &val);
 
-  if(num_ops != 0){
-    for(i = 0; i < num_ops / n_threads; i++){
-      action = (rand()%100) / 100.0;
-      val = rand() % datasetsize;
+    if (op == OP_LOOKUP) {
+      result = lookup(val);
 
-      if (action < lookupPct) {
-        p->in = val;
-        lookup(p);
-        result = p->out;
-
-        if (result)
-          l_lookups_true++;
-        else
-          l_lookups_false++;
-
-        if(verbose) printf("%u -> lookup %d : %d\n", tid, val, result);
-      }
-      else if (action < insertPct) {
-        if(verbose) printf("%u -> insert %d\n", tid, val);
-        insert(val);
-        l_inserts++;
-      }
-      else {
-        if(verbose) printf("%u -> remove %d\n", tid, val);
-        removeNode(val);
-        l_removes++;
-      }
+      if (result)
+        st.lookups_true++;
+      else
+        st.lookups_false++;
 
-      //int sane = isSane();
-      l_ops++;
+      if(verbose) printf("%u -> lookup %d : %d\n", tid, val, result);
     }
-    // Time duration mode
-  } else {
-    //printf("%d Entrou time duration mode\n",tid);
-    while(timeDiff < duration){
-      action = (rand()%100) / 100.0;
-      val = rand() % datasetsize;
-      if (action < lookupPct) {
-        p->in = val;
-        lookup(p);
-        result = p->out;
-
-        if (result)
-          l_lookups_true++;
-        else
-          l_lookups_false++;
-
-        if(verbose) printf("%u -> lookup %d : %d\n", tid, val, result);
-      }
-      else if (action < insertPct) {
-        if(verbose) printf("%u -> insert %d\n", tid, val);
-        insert(val);
-        l_inserts++;
-      }
-      else {
-        if(verbose) printf("%u -> remove %d\n", tid, val);
-        removeNode(val);
-        l_removes++;
-      }
-
-      //int sane = isSane();
-      l_ops++;
-
-      if(tid == 0){
-        clock_gettime(CLOCK_MONOTONIC, &tend);
-        timeDiff = ((double)tend.tv_sec + 1.0e-9*tend.tv_nsec) - ((double)tstart.tv_sec + 1.0e-9*tstart.tv_nsec);
-      }
+    else if (op == OP_INSERT) {
+      if(verbose) printf("%u -> insert %d\n", tid, val);
+      insert(val);
+      st.inserts++;
+    }
+    else {
+      if(verbose) printf("%u -> remove %d\n", tid, val);
+      removeNode(val);
+      st.removes++;
     }
-  }
 
-  pthread_mutex_lock(&mutex);
-  count_ops += l_ops;
-  inserts += l_inserts;
-  lookups_true += l_lookups_true;
-  lookups_false += l_lookups_false;
-  removes += l_removes;
-  pthread_mutex_unlock(&mutex);
+    l_ops++;
+    timerCount(tid, l_ops);
+  }
+  st.ops += l_ops;
 }
 
 /* Checa se os parametros são validos, aborta caso não sejam */
@@ -362,6 +382,26 @@ void checkData(){
     printf("Modo Número de operações: Valor inválido. Abortando...\n");
     exit(1);
   }
+
+  if(lookupPct < 0 || lookupPct > 1){
+    printf("Fração de lookups inválida. Abortando...\n");
+    exit(1);
+  }
+
+  if(insertFrac < 0 || insertPct > 1.0001f){
+    printf("Fração de inserts inválida. Abortando...\n");
+    exit(1);
+  }
+
+  if(sampleMs < 0){
+    printf("Intervalo de amostragem inválido. Abortando...\n");
+    exit(1);
+  }
+
+  if(tracePath != NULL && n_threads > (int) workload.trace->n_threads){
+    printf("O trace só tem operações para %u threads. Abortando...\n", workload.trace->n_threads);
+    exit(1);
+  }
 }
 
 void printInfo(){
@@ -373,6 +413,8 @@ void printInfo(){
   printf("\nTamanho máximo da fila = %d nodes", datasetsize);
   printf("\nPorcentagens das operações: %.2f Lookup / %.2f Insert / %.2f Remove",
             lookupPct, insertPct - lookupPct, 1.0f - insertPct);
+  workloadPrintInfo();
+  placementPrintInfo(n_threads);
 
   if(doWarmup)
     printf("\nWarm Up: ativado");
@@ -403,9 +445,11 @@ using namespace tbb;
 
     };
 
+    // grain 1: each tid is a task of its own, taken by a different thread
+    // of the arena as long as it has one free
     void ParallelApplyExperiment( int a[], size_t n ) {
 
-    parallel_for(blocked_range<size_t>(0,n), ApplyExperiment(a));
+    parallel_for(blocked_range<size_t>(0,n,1), ApplyExperiment(a), simple_partitioner());
 }
 
 int main(int argc, char *argv[]) {
@@ -413,18 +457,22 @@ int main(int argc, char *argv[]) {
   printf("\nLinked List - versão TBB\n");
 
 	getArgs(argc, argv);
+  placementInit();
+  workloadInit(tracePath, &datasetsize, &lookupPct, &insertPct);
 	checkData();
   printInfo();
-  tbb::task_scheduler_init init(n_threads);
+
+  // a arena tem n_threads vagas, a thread principal ocupa uma; o
+  // global_control deixa a TBB criar mais workers que CPUs, como o -n das
+  // outras versões faz
+  tbb::global_control parallelism(tbb::global_control::max_allowed_parallelism, n_threads);
+  tbb::task_arena arena(n_threads);
 
   /* Inicializa a lista criando a sentinela */
   sentinela = (LLNode*) malloc(sizeof(LLNode));
   sentinela->val = -1;
   sentinela->next = NULL;
 
-  pthread_t threads[n_threads];
-  void* pth_status;
-
   /* Warm Up */
   // warmup inserts half of the elements in the datasetsize
   if(doWarmup){
@@ -438,18 +486,31 @@ int main(int argc, char *argv[]) {
     pids[i] = i;
   }
 
+  timerInit(n_threads, num_ops != 0 ? 0 : duration, sampleMs, seriesPath);
   clock_gettime(CLOCK_MONOTONIC, &tstart);
   timeDiff = 0;
+  timerStart();
 
   printf("\n\n\t--- Rodando experimentos ---\n");
 
-  ParallelApplyExperiment(pids, n_threads);
+  arena.execute([&]{ ParallelApplyExperiment(pids, n_threads); });
 
+  timerStop();
   clock_gettime(CLOCK_MONOTONIC, &tend);
   timeDiff = ((double)tend.tv_sec + 1.0e-9*tend.tv_nsec) - ((double)tstart.tv_sec + 1.0e-9*tstart.tv_nsec);
 
   printf("\t    FIM DA EXECUÇÃO.\n");
 
+  int tbb_threads = 0;
+  for(const thread_stats_t& st : thread_stats){
+    count_ops += st.ops;
+    lookups_true += st.lookups_true;
+    lookups_false += st.lookups_false;
+    inserts += st.inserts;
+    removes += st.removes;
+    tbb_threads += st.experiments > 0;
+  }
+
   if(verbose) printLista();
   printf("\nSanity Check: ");
   if(isSane())
@@ -463,6 +524,8 @@ int main(int argc, char *argv[]) {
   printf("Total de lookups falhados: %d\n", lookups_false);
   printf("Total de Inserts: %d\n", inserts);
   printf("Total de removes: %d\n", removes);
+  printf("Threads da TBB que rodaram experimentos: %d de %d\n", tbb_threads, n_threads);
+  timerPrintSeries();
 
   return 0;
 }
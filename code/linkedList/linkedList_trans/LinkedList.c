@@ -7,6 +7,10 @@
 #include <getopt.h>
 #include <time.h>
 #include <pthread.h>
+#include "NodePool.h"
+#include "Workload.h"
+#include "Timer.h"
+#include "Placement.h"
 
 #define TRUE 1
 #define FALSE 0
@@ -32,7 +36,11 @@ static int removes = 0;
 static int datasetsize = 256;                  // number of items
 static double duration = 5.0f;                 // in seconds
 static int doWarmup = FALSE;
+static int usePool = FALSE;                    // aloca nós do pool por thread
 static int verbose = FALSE;
+static char* tracePath = NULL;                 // trace binário para replay (-r)
+static int sampleMs = 0;                       // intervalo da série de vazão (-I)
+static char* seriesPath = NULL;                // arquivo CSV da série (-o)
 static int num_ops = 0;                        // number of operations mode value.
 static int count_ops = 0;
 static int n_threads = 2;
@@ -40,6 +48,7 @@ static int n_threads = 2;
 // these three are for getting various lookup/insert/remove ratios
 static float lookupPct = 0.34f;
 static float insertPct = 0.67f;
+static float insertFrac = -1.0f;               // -1: metade do que sobra dos lookups
 
 // Controla o tempo de execução
 struct timespec tstart, tend;
@@ -66,6 +75,15 @@ void help(int msg){
 	printf("\n\ts : Tamanho do datasetsize [256]");
   printf("\n\tt : Tempo de duração da execução (segundos) [5.0]");
   printf("\n\tw : Ativa o Warm Up antes da execução [FALSE]");
+  printf("\n\tp : Aloca os nós de um pool por thread em vez de malloc/free [FALSE]");
+  printf("\n\tl : Fração de lookups [0.34]");
+  printf("\n\ti : Fração de inserts, o resto são removes [metade do que sobra dos lookups]");
+  printf("\n\tk : Distribuição das chaves: uniform, zipf[:theta], hotspot[:chaves[:ops]] ou seq [uniform]");
+  printf("\n\tr : Reproduz as operações de um trace gerado pelo tracegen");
+  printf("\n\tI : Amostra a vazão de cada thread a cada I ms [desativado]");
+  printf("\n\to : Grava a série de vazão em um arquivo CSV em vez da saída padrão");
+  printf("\n\ta : Afinidade: compact, scatter ou list:0,2,4-7 [nenhuma]");
+  printf("\n\tN : Política de memória NUMA: local ou interleave [padrão do sistema]");
   printf("\n\tv : Ativa o modo verbose.");
   printf("\n\tx : Muda para o modo de execução por número de operações.");
   printf("\n\th : Mostra essa mensagem\n\n");
@@ -82,11 +100,20 @@ void getArgs(int argc, char *argv[]){
     {"size", 1, NULL, 's'},
     {"time", 1, NULL, 't'},
     {"warmup", 0, NULL, 'w'},
+    {"pool", 0, NULL, 'p'},
     {"verbose", 0, NULL, 'v'},
+    {"replay", 1, NULL, 'r'},
+    {"lookup", 1, NULL, 'l'},
+    {"insert", 1, NULL, 'i'},
+    {"keys", 1, NULL, 'k'},
+    {"interval", 1, NULL, 'I'},
+    {"series", 1, NULL, 'o'},
+    {"affinity", 1, NULL, 'a'},
+    {"numa", 1, NULL, 'N'},
     {"x", 1, NULL, 'x'}
 	};
 
-	while ((op = getopt_long(argc, argv, "n:s:t:wvx:h", longopts, NULL)) != -1) {
+	while ((op = getopt_long(argc, argv, "n:s:t:wpvx:l:i:k:r:I:o:a:N:h", longopts, NULL)) != -1) {
 		switch (op) {
       case 'n':
         n_threads = atoi(optarg);
@@ -104,6 +131,10 @@ void getArgs(int argc, char *argv[]){
         doWarmup = TRUE;
         break;
 
+      case 'p':
+        usePool = TRUE;
+        break;
+
       case 'v':
         verbose = TRUE;
         break;
@@ -112,6 +143,38 @@ void getArgs(int argc, char *argv[]){
         num_ops = atoi(optarg);
         break;
 
+      case 'l':
+        lookupPct = atof(optarg);
+        break;
+
+      case 'i':
+        insertFrac = atof(optarg);
+        break;
+
+      case 'k':
+        workloadDist(optarg);
+        break;
+
+      case 'I':
+        sampleMs = atoi(optarg);
+        break;
+
+      case 'o':
+        seriesPath = optarg;
+        break;
+
+      case 'a':
+        placementAffinity(optarg);
+        break;
+
+      case 'N':
+        placementNuma(optarg);
+        break;
+
+      case 'r':
+        tracePath = optarg;
+        break;
+
       case 'h':
         help(0);
         break;
@@ -121,6 +184,11 @@ void getArgs(int argc, char *argv[]){
         break;
       }
     }
+
+  // a fração de removes é o que sobra
+  if(insertFrac < 0)
+    insertFrac = (1.0f - lookupPct) / 2;
+  insertPct = lookupPct + insertFrac;
 }
 
 /* Sanity Check */
@@ -147,6 +215,13 @@ int isSane(){
 // insert method; find the right place in the list, add val so that it is in
 // sorted order; if val is already in the list, exit without inserting
 void insert(int val) {
+  // poolAlloc/poolFree não são transaction_safe: com o pool o nó é alocado
+  // antes da transação e devolvido depois se não foi usado
+  LLNode *pre = NULL;
+  int used = FALSE;
+  if (usePool)
+    pre = poolAlloc();
+
   __transaction_atomic{
     // traverse the list to find the insertion point
     LLNode *prev = sentinela;
@@ -166,14 +241,20 @@ void insert(int val) {
       // ESCRITA : REGIÃO CRITICA
 
       LLNode *insert_point = prev;
-      LLNode *novo = malloc(sizeof(LLNode));
+      LLNode *novo = pre;
+      if (!usePool)
+        novo = malloc(sizeof(LLNode));
       novo->val = val;
       novo->next = curr;
 
       insert_point->next = novo;
+      used = TRUE;
       // FIM
     }
   }
+
+  if (usePool && !used)
+    poolFree(pre);
 }
 
 // search function
@@ -202,6 +283,8 @@ void lookup(void* arg){
 
 // remove a node if its value == val
 void removeNode(int val){
+  LLNode *removed = NULL;
+
   __transaction_atomic
   {
     // find the node whose val matches the request
@@ -217,7 +300,10 @@ void removeNode(int val){
         mod_point->next = curr->next;
 
         // delete curr...
-        free(curr);
+        if (usePool)
+          removed = curr;
+        else
+          free(curr);
         // FIM
         break;
       } else if (curr->val > val) {
@@ -228,6 +314,9 @@ void removeNode(int val){
       curr = prev->next;
     }
   }
+
+  if (removed != NULL)
+    poolFree(removed);
 }
 
 // print the list
@@ -250,26 +339,28 @@ void* experiment(void* arg){
   __transaction_atomic{
     tid = gtid++;
   }
+  placementPin(tid);
+  if(usePool) poolRegister(tid);
 
   //printf("tid = %d\n", tid);
   int result, val, i;
-  float action;
+  int op;
+  workload_t w;
   int l_ops, l_lookups_true, l_lookups_false, l_inserts, l_removes;
   l_ops = l_lookups_true = l_lookups_false = l_inserts = l_removes = 0;
 
   pthread_arg* p;
   p = malloc(sizeof(pthread_arg));
 
-  srand(time(NULL) + tid);
+  workloadThread(&w, tid);
 
   //printf("\nAction = %f | val = %d\n", action, val);
 
   if(num_ops != 0){
     for(i = 0; i < num_ops / n_threads; i++){
-      action = (rand()%100) / 100.0;
-      val = rand() % datasetsize;
+      op = workloadNext(&w, &val);
 
-      if (action < lookupPct) {
+      if (op == OP_LOOKUP) {
         p->in = val;
         lookup(p);
         result = p->out;
@@ -281,7 +372,7 @@ void* experiment(void* arg){
 
         if(verbose) printf("%d -> lookup %d : %d\n", tid, val, result);
       }
-      else if (action < insertPct) {
+      else if (op == OP_INSERT) {
         if(verbose) printf("%d -> insert %d\n", tid, val);
         insert(val);
         l_inserts++;
@@ -294,14 +385,14 @@ void* experiment(void* arg){
 
       //int sane = isSane();
       l_ops++;
+      timerCount(tid, l_ops);
     }
     // Time duration mode
   } else {
     //printf("%d Entrou time duration mode\n",tid);
-    while(timeDiff < duration){
-      action = (rand()%100) / 100.0;
-      val = rand() % datasetsize;
-      if (action < lookupPct) {
+    while(timerRunning()){
+      op = workloadNext(&w, &val);
+      if (op == OP_LOOKUP) {
         p->in = val;
         lookup(p);
         result = p->out;
@@ -313,7 +404,7 @@ void* experiment(void* arg){
 
         if(verbose) printf("%d -> lookup %d : %d\n", tid, val, result);
       }
-      else if (action < insertPct) {
+      else if (op == OP_INSERT) {
         if(verbose) printf("%d -> insert %d\n", tid, val);
         insert(val);
         l_inserts++;
@@ -326,11 +417,7 @@ void* experiment(void* arg){
 
       //int sane = isSane();
       l_ops++;
-
-      if(tid == 0){
-        clock_gettime(CLOCK_MONOTONIC, &tend);
-        timeDiff = ((double)tend.tv_sec + 1.0e-9*tend.tv_nsec) - ((double)tstart.tv_sec + 1.0e-9*tstart.tv_nsec);
-      }
+      timerCount(tid, l_ops);
     }
   }
 
@@ -364,6 +451,26 @@ void checkData(){
     printf("Modo Número de operações: Valor inválido. Abortando...\n");
     exit(1);
   }
+
+  if(lookupPct < 0 || lookupPct > 1){
+    printf("Fração de lookups inválida. Abortando...\n");
+    exit(1);
+  }
+
+  if(insertFrac < 0 || insertPct > 1.0001f){
+    printf("Fração de inserts inválida. Abortando...\n");
+    exit(1);
+  }
+
+  if(sampleMs < 0){
+    printf("Intervalo de amostragem inválido. Abortando...\n");
+    exit(1);
+  }
+
+  if(tracePath != NULL && n_threads > (int) workload.trace->n_threads){
+    printf("O trace só tem operações para %u threads. Abortando...\n", workload.trace->n_threads);
+    exit(1);
+  }
 }
 
 void printInfo(){
@@ -375,11 +482,18 @@ void printInfo(){
   printf("\nTamanho máximo da fila = %d nodes", datasetsize);
   printf("\nPorcentagens das operações: %.2f Lookup / %.2f Insert / %.2f Remove",
             lookupPct, insertPct - lookupPct, 1.0f - insertPct);
+  workloadPrintInfo();
+  placementPrintInfo(n_threads);
 
   if(doWarmup)
     printf("\nWarm Up: ativado");
   else
     printf("\nWarm Up: desativado");
+
+  if(usePool)
+    printf("\nAlocação de nós: pool por thread");
+  else
+    printf("\nAlocação de nós: malloc/free");
 }
 
 int main(int argc, char *argv[]) {
@@ -387,6 +501,8 @@ int main(int argc, char *argv[]) {
   printf("\nLinked List - versão Transações\n");
 
 	getArgs(argc, argv);
+  placementInit();
+  workloadInit(tracePath, &datasetsize, &lookupPct, &insertPct);
 	checkData();
   printInfo();
 
@@ -395,6 +511,8 @@ int main(int argc, char *argv[]) {
   sentinela->val = -1;
   sentinela->next = NULL;
 
+  if(usePool) poolInit(n_threads, sizeof(LLNode));
+
   pthread_t threads[n_threads];
   void* pth_status;
 
@@ -406,8 +524,10 @@ int main(int argc, char *argv[]) {
       }
   }
 
+  timerInit(n_threads, num_ops != 0 ? 0 : duration, sampleMs, seriesPath);
   clock_gettime(CLOCK_MONOTONIC, &tstart);
   timeDiff = 0;
+  timerStart();
 
   printf("\n\n\t--- Rodando experimentos ---\n");
   for(i = 0; i < n_threads; i++){
@@ -420,6 +540,7 @@ int main(int argc, char *argv[]) {
 		 pthread_join(threads[i], &pth_status);
 	}
 
+  timerStop();
   clock_gettime(CLOCK_MONOTONIC, &tend);
   timeDiff = ((double)tend.tv_sec + 1.0e-9*tend.tv_nsec) - ((double)tstart.tv_sec + 1.0e-9*tstart.tv_nsec);
 
@@ -438,6 +559,12 @@ int main(int argc, char *argv[]) {
   printf("Total de lookups falhados: %d\n", lookups_false);
   printf("Total de Inserts: %d\n", inserts);
   printf("Total de removes: %d\n", removes);
+  timerPrintSeries();
+
+  if(usePool){
+    poolPrintStats();
+    poolDestroy();
+  }
 
   return 0;
 }
@@ -0,0 +1,169 @@
+/* Gerador de traces binários para o benchmark LinkedList */
+/* O trace é reproduzido pelas versões da lista com -r    */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+#include <time.h>
+#include "Workload.h"
+
+#define TRUE 1
+#define FALSE 0
+
+/* Dados globais com valores padrão */
+static int datasetsize = 256;                  // number of items
+static int n_threads = 2;
+static long num_ops = 1000000;                 // operações por thread
+static unsigned int seed = 1;
+static char* outPath = "trace.bin";
+
+// these three are for getting various lookup/insert/remove ratios
+static float lookupPct = 0.34f;
+static float insertPct = 0.67f;
+static float insertFrac = -1.0f;               // -1: metade do que sobra dos lookups
+
+/* Exibe ajuda e finaliza o programa */
+void help(int msg){
+  switch (msg) {
+    case 1:
+      printf("\nNúmero insuficiente de parametros!\n");
+      break;
+
+    case 2:
+      printf("\nParametros de entrada inválidos!\n");
+      break;
+
+    default:
+      break;
+  }
+
+  printf("\n\tn : Número de threads do trace [2]");
+  printf("\n\ts : Tamanho do datasetsize [256]");
+  printf("\n\tx : Número de operações por thread [1000000]");
+  printf("\n\tl : Fração de lookups [0.34]");
+  printf("\n\ti : Fração de inserts, o resto são removes [metade do que sobra dos lookups]");
+  printf("\n\tk : Distribuição das chaves: uniform, zipf[:theta], hotspot[:chaves[:ops]] ou seq [uniform]");
+  printf("\n\tr : Semente do gerador [1]");
+  printf("\n\to : Arquivo de saída [trace.bin]");
+  printf("\n\th : Mostra essa mensagem\n\n");
+  exit(1);
+}
+
+/* Pega argumentos com getopt */
+void getArgs(int argc, char *argv[]){
+  extern char *optarg;
+  char op;
+
+  struct option longopts[] = {
+    {"n_threads", 1, NULL, 'n'},
+    {"size", 1, NULL, 's'},
+    {"x", 1, NULL, 'x'},
+    {"lookup", 1, NULL, 'l'},
+    {"insert", 1, NULL, 'i'},
+    {"keys", 1, NULL, 'k'},
+    {"seed", 1, NULL, 'r'},
+    {"output", 1, NULL, 'o'},
+    {0, 0, 0, 0}
+  };
+
+  while ((op = getopt_long(argc, argv, "n:s:x:l:i:k:r:o:h", longopts, NULL)) != -1) {
+    switch (op) {
+      case 'n':
+        n_threads = atoi(optarg);
+        break;
+
+      case 's':
+        datasetsize = atoi(optarg);
+        break;
+
+      case 'x':
+        num_ops = atol(optarg);
+        break;
+
+      case 'l':
+        lookupPct = atof(optarg);
+        break;
+
+      case 'i':
+        insertFrac = atof(optarg);
+        break;
+
+      case 'k':
+        workloadDist(optarg);
+        break;
+
+      case 'r':
+        seed = strtoul(optarg, NULL, 10);
+        break;
+
+      case 'o':
+        outPath = optarg;
+        break;
+
+      case 'h':
+        help(0);
+        break;
+
+      default:
+        help(2);
+        break;
+    }
+  }
+
+  // a fração de removes é o que sobra
+  if(insertFrac < 0)
+    insertFrac = (1.0f - lookupPct) / 2;
+  insertPct = lookupPct + insertFrac;
+}
+
+/* Checa se os parametros são validos, aborta caso não sejam */
+void checkData(){
+  if(n_threads < 1){
+    printf("Número inválido de threads. Abortando...\n");
+    exit(1);
+  }
+
+  // a chave ocupa TRACE_KEY_BITS bits do registro
+  if(datasetsize < 1 || datasetsize > (int) TRACE_KEY_MASK + 1){
+    printf("Tamanho da lista inválida. Abortando...\n");
+    exit(1);
+  }
+
+  if(num_ops < 1){
+    printf("Número de operações inválido. Abortando...\n");
+    exit(1);
+  }
+
+  if(lookupPct < 0 || lookupPct > 1){
+    printf("Fração de lookups inválida. Abortando...\n");
+    exit(1);
+  }
+
+  if(insertFrac < 0 || insertPct > 1.0001f){
+    printf("Fração de inserts inválida. Abortando...\n");
+    exit(1);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  printf("\nLinked List - gerador de traces\n");
+
+  getArgs(argc, argv);
+  checkData();
+  workloadConfig(datasetsize, lookupPct, insertPct);
+
+  printf("\nNúmero de threads = %d", n_threads);
+  printf("\nOperações por thread = %ld", num_ops);
+  printf("\nTamanho máximo da fila = %d nodes", datasetsize);
+  printf("\nPorcentagens das operações: %.2f Lookup / %.2f Insert / %.2f Remove",
+            lookupPct, insertPct - lookupPct, 1.0f - insertPct);
+  workloadPrintInfo();
+  printf("\nSemente = %u\n", seed);
+
+  workloadWriteTrace(outPath, n_threads, num_ops, seed);
+
+  printf("Trace gravado em %s (%ld bytes)\n", outPath,
+         (long) (sizeof(trace_header_t) + sizeof(uint32_t) * n_threads * num_ops));
+
+  return 0;
+}
@@ -1,7 +1,11 @@
 #!/bin/bash
 progs="linkedList barnes"
 modes="seq mutex spin semaforo trans psemaforo"
-not_modes="ptrans tbb"
+not_modes="ptrans"
+# Versões que só existem para o linkedList
+list_modes="lockfree handoverhand lazy rwlock brlock skiplist plockfree tbb"
+# Versões que só existem para o barnes
+barnes_modes="qlock stm"
 count="1 2 3 4 5 6 7 8 9 10 11"
 n_procs="2 4 8 16"
 dirs_home="$PWD"
@@ -15,7 +19,13 @@ for p in $progs; do
 	echo
 	echo -e "\tCompilando $p"
 	echo
-	for m in $modes; do
+	p_modes="$modes"
+	if [ "$p" == "linkedList" ]; then
+		p_modes="$modes $list_modes"
+	else
+		p_modes="$modes $barnes_modes"
+	fi
+	for m in $p_modes; do
 		pm="$p"_"$m"
 		echo "Compilando $pm"
 		cd "$p/$pm/"
@@ -34,7 +44,13 @@ echo
 for p in $progs; do
         echo -e "\tExecutando $p"
         echo
-        for m in $modes; do
+        p_modes="$modes"
+        if [ "$p" == "linkedList" ]; then
+                p_modes="$modes $list_modes"
+        else
+                p_modes="$modes $barnes_modes"
+        fi
+        for m in $p_modes; do
 		pm="$p"_"$m"
 		out=$dirs_home/../out/$p/$pm
 		echo "-----Executando $pm-----"
@@ -0,0 +1,37 @@
+#!/bin/bash
+# Execução do linkedList_backends variando a versão da lista (-m)
+# Um binário só: as diferenças medidas vêm apenas da sincronização
+backends="mutex spin sem rwlock brlock ticket mcs clh adaptive tm stm tbb handoverhand lazy lockfree skiplist unrolled cow fc delegate"
+count="1 2 3 4 5 6 7 8 9 10 11"
+n_procs="2 4 8 16"
+dirs_home="$PWD"
+pm=linkedList_backends
+
+echo Começando a execução a partir de $dirs_home
+echo
+
+echo -e "\tCompilando $pm"
+cd "linkedList/$pm/"
+make
+cd "../../"
+echo "-----Fim $pm-----"
+echo
+
+echo -e "\tExecutando programas"
+echo
+
+cd "linkedList/$pm/"
+for b in $backends; do
+	for n in $n_procs; do
+		out=$dirs_home/../out/linkedList/backends/$b/$n
+		mkdir -p "$out"
+		echo "-----Executando $pm -m $b com $n fluxos-----"
+		for i in $count; do
+			echo "-----Executando run $i-----"
+			perf stat -d -o $out/perfout$i.txt ./$pm -m "$b" -n "$n" > $out/out$i.txt
+			echo "-----Fim run $i-----"
+		done
+	done
+done
+cd "../.."
+echo
@@ -0,0 +1,40 @@
+#!/bin/bash
+# Execução do linkedList_backends com operações em lotes (-b)
+# Mostra quanto o lote amortiza o lock e a travessia da lista
+backends="mutex spin rwlock tm"
+batches="1 4 16 64"
+count="1 2 3 4 5 6 7 8 9 10 11"
+n_procs="2 4 8 16"
+dirs_home="$PWD"
+pm=linkedList_backends
+
+echo Começando a execução a partir de $dirs_home
+echo
+
+echo -e "\tCompilando $pm"
+cd "linkedList/$pm/"
+make
+cd "../../"
+echo "-----Fim $pm-----"
+echo
+
+echo -e "\tExecutando programas"
+echo
+
+cd "linkedList/$pm/"
+for b in $backends; do
+	for k in $batches; do
+		for n in $n_procs; do
+			out=$dirs_home/../out/linkedList/batch/$b/$k/$n
+			mkdir -p "$out"
+			echo "-----Executando $pm -m $b em lotes de $k com $n fluxos-----"
+			for i in $count; do
+				echo "-----Executando run $i-----"
+				perf stat -d -o $out/perfout$i.txt ./$pm -m "$b" -b "$k" -n "$n" -w > $out/out$i.txt
+				echo "-----Fim run $i-----"
+			done
+		done
+	done
+done
+cd "../.."
+echo
@@ -0,0 +1,53 @@
+#!/bin/bash
+# Execução do linkedList com e sem EBR (-e) nas versões com lock global
+# Mostra quanto custa a reclamação por épocas em relação ao free imediato
+modes="mutex spin semaforo"
+reclaims="free ebr"
+count="1 2 3 4 5 6 7 8 9 10 11"
+n_procs="2 4 8 16"
+dirs_home="$PWD"
+
+echo Começando a execução a partir de $dirs_home
+echo
+
+echo -e "\tCompilando programas"
+echo
+
+for m in $modes; do
+	pm=linkedList_"$m"
+	echo "Compilando $pm"
+	cd "linkedList/$pm/"
+	make
+	cd "../../"
+	echo "-----Fim $pm-----"
+	echo
+done
+
+echo -e "\tExecutando programas"
+echo
+
+for m in $modes; do
+	pm=linkedList_"$m"
+	echo "-----Executando $pm-----"
+	cd "linkedList/$pm/"
+	for r in $reclaims; do
+		flag=""
+		if [ "$r" == "ebr" ]; then
+			flag="-e"
+		fi
+		for n in $n_procs; do
+			out=$dirs_home/../out/linkedList/ebr/$pm/$r/$n
+			mkdir -p "$out"
+			echo "-----Executando $pm com $n fluxos e reclamação $r-----"
+			for i in $count; do
+				echo "-----Executando run $i-----"
+				perf stat -d -o $out/perfout$i.txt ./$pm -n "$n" $flag > $out/out$i.txt
+				echo "-----Fim run $i-----"
+			done
+		done
+	done
+	cd "../.."
+	echo "-----Fim $pm-----"
+	echo
+done
+echo
@@ -0,0 +1,37 @@
+#!/bin/bash
+# Execução do linkedList_backends com flat combining e delegação contra os locks simples
+# Com muitos fluxos o combinador e o servidor devem ganhar do mutex e do spin
+backends="fc delegate mutex spin"
+count="1 2 3 4 5 6 7 8 9 10 11"
+n_procs="2 4 8 16"
+dirs_home="$PWD"
+pm=linkedList_backends
+
+echo Começando a execução a partir de $dirs_home
+echo
+
+echo -e "\tCompilando $pm"
+cd "linkedList/$pm/"
+make
+cd "../../"
+echo "-----Fim $pm-----"
+echo
+
+echo -e "\tExecutando programas"
+echo
+
+cd "linkedList/$pm/"
+for b in $backends; do
+	for n in $n_procs; do
+		out=$dirs_home/../out/linkedList/fc/$b/$n
+		mkdir -p "$out"
+		echo "-----Executando $pm -m $b com $n fluxos-----"
+		for i in $count; do
+			echo "-----Executando run $i-----"
+			perf stat -d -o $out/perfout$i.txt ./$pm -m "$b" -n "$n" > $out/out$i.txt
+			echo "-----Fim run $i-----"
+		done
+	done
+done
+cd "../.."
+echo
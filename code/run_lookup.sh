@@ -0,0 +1,49 @@
+#!/bin/bash
+# Matriz de execução do linkedList variando a fração de lookups (-l)
+# Mostra a partir de qual porcentagem compartilhar a leitura compensa
+modes="mutex rwlock brlock"
+lookups="0.0 0.34 0.5 0.8 0.9 0.99"
+count="1 2 3 4 5 6 7 8 9 10 11"
+n_procs="2 4 8 16"
+dirs_home="$PWD"
+
+echo Começando a execução a partir de $dirs_home
+echo
+
+echo -e "\tCompilando programas"
+echo
+
+for m in $modes; do
+	pm=linkedList_"$m"
+	echo "Compilando $pm"
+	cd "linkedList/$pm/"
+	make
+	cd "../../"
+	echo "-----Fim $pm-----"
+	echo
+done
+
+echo -e "\tExecutando programas"
+echo
+
+for m in $modes; do
+	pm=linkedList_"$m"
+	echo "-----Executando $pm-----"
+	cd "linkedList/$pm/"
+	for l in $lookups; do
+		for n in $n_procs; do
+			out=$dirs_home/../out/linkedList/lookup/$pm/$l/$n
+			mkdir -p "$out"
+			echo "-----Executando $pm com $n fluxos e $l lookups-----"
+			for i in $count; do
+				echo "-----Executando run $i-----"
+				perf stat -d -o $out/perfout$i.txt ./$pm -n "$n" -l "$l" > $out/out$i.txt
+				echo "-----Fim run $i-----"
+			done
+		done
+	done
+	cd "../.."
+	echo "-----Fim $pm-----"
+	echo
+done
+echo
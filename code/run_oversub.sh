@@ -0,0 +1,37 @@
+#!/bin/bash
+# Execução do linkedList_backends com mais threads que CPUs (-O)
+# Compara quem só gira (spin), quem dorme cedo (mutex, sem) e o adaptive
+backends="spin mutex sem mcs adaptive"
+count="1 2 3 4 5 6 7 8 9 10 11"
+factors="1 2 4"
+dirs_home="$PWD"
+pm=linkedList_backends
+
+echo Começando a execução a partir de $dirs_home
+echo
+
+echo -e "\tCompilando $pm"
+cd "linkedList/$pm/"
+make
+cd "../../"
+echo "-----Fim $pm-----"
+echo
+
+echo -e "\tExecutando programas"
+echo
+
+cd "linkedList/$pm/"
+for b in $backends; do
+	for f in $factors; do
+		out=$dirs_home/../out/linkedList/oversub/$b/$f
+		mkdir -p "$out"
+		echo "-----Executando $pm -m $b com $f threads por CPU-----"
+		for i in $count; do
+			echo "-----Executando run $i-----"
+			perf stat -d -o $out/perfout$i.txt ./$pm -m "$b" -O "$f" > $out/out$i.txt
+			echo "-----Fim run $i-----"
+		done
+	done
+done
+cd "../.."
+echo
@@ -0,0 +1,52 @@
+#!/bin/bash
+# Execução do linkedList alocando os nós com malloc ou com o pool por thread (-p)
+modes="mutex spin semaforo trans rwlock brlock handoverhand lockfree lazy"
+allocs="malloc pool"
+count="1 2 3 4 5 6 7 8 9 10 11"
+n_procs="2 4 8 16"
+dirs_home="$PWD"
+
+echo Começando a execução a partir de $dirs_home
+echo
+
+echo -e "\tCompilando programas"
+echo
+
+for m in $modes; do
+	pm=linkedList_"$m"
+	echo "Compilando $pm"
+	cd "linkedList/$pm/"
+	make
+	cd "../../"
+	echo "-----Fim $pm-----"
+	echo
+done
+
+echo -e "\tExecutando programas"
+echo
+
+for m in $modes; do
+	pm=linkedList_"$m"
+	echo "-----Executando $pm-----"
+	cd "linkedList/$pm/"
+	for a in $allocs; do
+		flag=""
+		if [ "$a" == "pool" ]; then
+			flag="-p"
+		fi
+		for n in $n_procs; do
+			out=$dirs_home/../out/linkedList/pool/$pm/$a/$n
+			mkdir -p "$out"
+			echo "-----Executando $pm com $n fluxos e alocação $a-----"
+			for i in $count; do
+				echo "-----Executando run $i-----"
+				perf stat -d -o $out/perfout$i.txt ./$pm -n "$n" $flag > $out/out$i.txt
+				echo "-----Fim run $i-----"
+			done
+		done
+	done
+	cd "../.."
+	echo "-----Fim $pm-----"
+	echo
+done
+echo
@@ -0,0 +1,53 @@
+#!/bin/bash
+# Varredura do tamanho do datasetsize (-s) com Warm Up, skip list contra as listas
+# As listas são O(n) por operação (e o Warm Up O(n^2)), então só rodam até list_max
+modes="skiplist mutex lockfree lazy"
+sizes="256 4096 65536 1048576 10000000"
+list_max=65536
+count="1 2 3 4 5 6 7 8 9 10 11"
+n_procs="2 4 8 16"
+dirs_home="$PWD"
+
+echo Começando a execução a partir de $dirs_home
+echo
+
+echo -e "\tCompilando programas"
+echo
+
+for m in $modes; do
+	pm=linkedList_"$m"
+	echo "Compilando $pm"
+	cd "linkedList/$pm/"
+	make
+	cd "../../"
+	echo "-----Fim $pm-----"
+	echo
+done
+
+echo -e "\tExecutando programas"
+echo
+
+for m in $modes; do
+	pm=linkedList_"$m"
+	echo "-----Executando $pm-----"
+	cd "linkedList/$pm/"
+	for s in $sizes; do
+		if [ "$m" != "skiplist" ] && [ "$s" -gt "$list_max" ]; then
+			continue
+		fi
+		for n in $n_procs; do
+			out=$dirs_home/../out/linkedList/size/$pm/$s/$n
+			mkdir -p "$out"
+			echo "-----Executando $pm com $n fluxos e $s nós-----"
+			for i in $count; do
+				echo "-----Executando run $i-----"
+				perf stat -d -o $out/perfout$i.txt ./$pm -n "$n" -s "$s" -w > $out/out$i.txt
+				echo "-----Fim run $i-----"
+			done
+		done
+	done
+	cd "../.."
+	echo "-----Fim $pm-----"
+	echo
+done
+echo